@@ -127,6 +127,18 @@ for my $state (@keys, '__CALL') {
     $cnt++;
 }
 say $enumfh '} cmdp_state;';
+
+# The kind of each token is determined here, so that the parser does not need
+# to compare token names at runtime.
+say $enumfh 'typedef enum {';
+say $enumfh '    TK_LITERAL = 0,';
+say $enumfh '    TK_STRING = 1,';
+say $enumfh '    TK_WORD = 2,';
+say $enumfh '    TK_NUMBER = 3,';
+say $enumfh '    TK_LINE = 4,';
+say $enumfh '    TK_END = 5,';
+say $enumfh '    TK_ERROR = 6,';
+say $enumfh '} cmdp_token_kind;';
 close($enumfh);
 
 # Third step: Generate the call function.
@@ -198,6 +210,19 @@ close($callfh);
 
 # Fourth step: Generate the token datastructures.
 
+my %kinds = (
+    string => 'TK_STRING',
+    word => 'TK_WORD',
+    number => 'TK_NUMBER',
+    line => 'TK_LINE',
+    end => 'TK_END',
+    error => 'TK_ERROR',
+);
+
+# States with at least this many literals get a dispatch table, see below.
+my $dispatch_min_literals = 4;
+my %has_dispatch;
+
 open(my $tokfh, '>', "GENERATED_${prefix}_tokens.h");
 
 for my $state (@keys) {
@@ -206,10 +231,16 @@ for my $state (@keys) {
     for my $token (@$tokens) {
         my $call_identifier = 0;
         my $token_name = $token->{token};
+        my ($kind, $name_len, $first) = ('TK_LITERAL', 0, 0);
         if ($token_name =~ /^'/) {
             # To make the C code simpler, we leave out the trailing single
             # quote of the literal. We can do strdup(literal + 1); then :).
             $token_name =~ s/'$//;
+            $name_len = length($token_name) - 1;
+            $first = ord(lc(substr($token_name, 1, 1)));
+        } else {
+            $kind = $kinds{$token_name};
+            die "Unknown token $token_name in state $state" unless defined($kind);
         }
         my $next_state = $token->{next_state};
         if ($next_state =~ /^call /) {
@@ -217,15 +248,45 @@ for my $state (@keys) {
             $next_state = '__CALL';
         }
         my $identifier = $token->{identifier};
-        say $tokfh qq|    { "$token_name", "$identifier", $next_state, { $call_identifier } }, |;
+        $identifier = (length($identifier) > 0 ? qq|"$identifier"| : 'NULL');
+        say $tokfh qq|    { "$token_name", $identifier, $next_state, { $call_identifier }, $kind, $name_len, $first }, |;
+    }
+    say $tokfh '};';
+
+    # For states with many literals (like INITIAL), generate a table which
+    # maps the (lowercase) first character of the input to the first token
+    # which can match it: either a literal starting with that character or a
+    # non-literal token. Index 0 (which no literal starts with) is used for
+    # non-ASCII input, so it also stops at literals starting with a non-ASCII
+    # byte (like '→').
+    my @literals = grep { $_->{token} =~ /^'/ } @$tokens;
+    next if @literals < $dispatch_min_literals;
+    die "Too many tokens in state $state" if @$tokens > 255;
+    my @dispatch;
+    for my $char (0 .. 127) {
+        my $lc = ord(lc(chr($char)));
+        my $idx = 0;
+        for my $token (@$tokens) {
+            last if $token->{token} !~ /^'/;
+            my $first = ord(lc(substr($token->{token}, 1, 1)));
+            last if $first == $lc || ($char == 0 && $first >= 128);
+            $idx++;
+        }
+        push @dispatch, $idx;
+    }
+    say $tokfh "static const uint8_t dispatch_${state}[128] = {";
+    for my $row (0 .. 15) {
+        say $tokfh '    ' . join(', ', @dispatch[($row * 8) .. ($row * 8 + 7)]) . ',';
     }
     say $tokfh '};';
+    $has_dispatch{$state} = 1;
 }
 
 say $tokfh 'static cmdp_token_ptr tokens[' . scalar @keys . '] = {';
 for my $state (@keys) {
     my $tokens = $states{$state};
-    say $tokfh '    { tokens_' . $state . ', ' . scalar @$tokens . ' },';
+    my $dispatch = ($has_dispatch{$state} ? "dispatch_$state" : 'NULL');
+    say $tokfh '    { tokens_' . $state . ', ' . scalar @$tokens . ", $dispatch },";
 }
 say $tokfh '};';
 
@@ -108,11 +108,15 @@ typedef struct token {
     union {
         uint16_t call_identifier;
     } extra;
+    cmdp_token_kind kind;
+    int name_len;
+    int first;
 } cmdp_token;
 
 typedef struct tokenptr {
     cmdp_token *array;
     int n;
+    const uint8_t *dispatch;
 } cmdp_token_ptr;
 
 #include "GENERATED_config_tokens.h"
@@ -328,15 +332,18 @@ static char *rewrite_binding(const char *input) {
         //printf("remaining input: %s\n", walk);
 
         cmdp_token_ptr *ptr = &(tokens[state]);
-        for (c = 0; c < ptr->n; c++) {
+        const int first = tolower((unsigned char)*walk);
+        c = (ptr->dispatch != NULL ? ptr->dispatch[first < 128 ? first : 0] : 0);
+        for (; c < ptr->n; c++) {
             token = &(ptr->array[c]);
 
             /* A literal. */
-            if (token->name[0] == '\'') {
-                if (strncasecmp(walk, token->name + 1, strlen(token->name) - 1) == 0) {
+            if (token->kind == TK_LITERAL) {
+                if (token->first == first &&
+                    strncasecmp(walk, token->name + 1, token->name_len) == 0) {
                     if (token->identifier != NULL)
                         push_string(token->identifier, token->name + 1);
-                    walk += strlen(token->name) - 1;
+                    walk += token->name_len;
                     if ((result = next_state(token)) != NULL)
                         return result;
                     break;
@@ -344,7 +351,7 @@ static char *rewrite_binding(const char *input) {
                 continue;
             }
 
-            if (strcmp(token->name, "number") == 0) {
+            if (token->kind == TK_NUMBER) {
                 /* Handle numbers. We only accept decimal numbers for now. */
                 char *end = NULL;
                 errno = 0;
@@ -367,8 +374,7 @@ static char *rewrite_binding(const char *input) {
                 break;
             }
 
-            if (strcmp(token->name, "string") == 0 ||
-                strcmp(token->name, "word") == 0) {
+            if (token->kind == TK_STRING || token->kind == TK_WORD) {
                 const char *beginning = walk;
                 /* Handle quoted strings (or words). */
                 if (*walk == '"') {
@@ -377,7 +383,7 @@ static char *rewrite_binding(const char *input) {
                     while (*walk != '\0' && (*walk != '"' || *(walk - 1) == '\\'))
                         walk++;
                 } else {
-                    if (token->name[0] == 's') {
+                    if (token->kind == TK_STRING) {
                         while (*walk != '\0' && *walk != '\r' && *walk != '\n')
                             walk++;
                     } else {
@@ -418,7 +424,7 @@ static char *rewrite_binding(const char *input) {
                 }
             }
 
-            if (strcmp(token->name, "end") == 0) {
+            if (token->kind == TK_END) {
                 //printf("checking for end: *%s*\n", walk);
                 if (*walk == '\0' || *walk == '\n' || *walk == '\r') {
                     if ((result = next_state(token)) != NULL)
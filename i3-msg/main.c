@@ -28,6 +28,7 @@
 #include <getopt.h>
 #include <limits.h>
 
+#include <yajl/yajl_gen.h>
 #include <yajl/yajl_parse.h>
 #include <yajl/yajl_version.h>
 
@@ -118,22 +119,95 @@ static yajl_callbacks reply_callbacks = {
     .yajl_end_map = reply_end_map_cb,
 };
 
+/*
+ * Callbacks which convert a CBOR-encoded reply back to (indented) JSON by
+ * passing each item on to a yajl generator.
+ *
+ */
+static int cbor_null_cb(void *gen) {
+    return yajl_gen_null(gen) == yajl_gen_status_ok;
+}
+
+static int cbor_boolean_cb(void *gen, int value) {
+    return yajl_gen_bool(gen, value) == yajl_gen_status_ok;
+}
+
+static int cbor_integer_cb(void *gen, long long value) {
+    return yajl_gen_integer(gen, value) == yajl_gen_status_ok;
+}
+
+static int cbor_double_cb(void *gen, double value) {
+    return yajl_gen_double(gen, value) == yajl_gen_status_ok;
+}
+
+static int cbor_string_cb(void *gen, const unsigned char *value, size_t length) {
+    return yajl_gen_string(gen, value, length) == yajl_gen_status_ok;
+}
+
+static int cbor_start_map_cb(void *gen) {
+    return yajl_gen_map_open(gen) == yajl_gen_status_ok;
+}
+
+static int cbor_end_map_cb(void *gen) {
+    return yajl_gen_map_close(gen) == yajl_gen_status_ok;
+}
+
+static int cbor_start_array_cb(void *gen) {
+    return yajl_gen_array_open(gen) == yajl_gen_status_ok;
+}
+
+static int cbor_end_array_cb(void *gen) {
+    return yajl_gen_array_close(gen) == yajl_gen_status_ok;
+}
+
+static cbor_callbacks cbor_to_json_callbacks = {
+    .cbor_null = cbor_null_cb,
+    .cbor_boolean = cbor_boolean_cb,
+    .cbor_integer = cbor_integer_cb,
+    .cbor_double = cbor_double_cb,
+    .cbor_string = cbor_string_cb,
+    .cbor_start_map = cbor_start_map_cb,
+    .cbor_map_key = cbor_string_cb,
+    .cbor_end_map = cbor_end_map_cb,
+    .cbor_start_array = cbor_start_array_cb,
+    .cbor_end_array = cbor_end_array_cb,
+};
+
+/*
+ * Prints a CBOR-encoded reply as indented JSON.
+ *
+ */
+static void print_cbor_reply(const uint8_t *reply, uint32_t reply_length) {
+    yajl_gen gen = yajl_gen_alloc(NULL);
+    yajl_gen_config(gen, yajl_gen_beautify, 1);
+    if (!cbor_parse(reply, reply_length, &cbor_to_json_callbacks, gen))
+        errx(EXIT_FAILURE, "IPC: Could not parse CBOR reply.");
+
+    const unsigned char *json;
+    size_t json_length;
+    yajl_gen_get_buf(gen, &json, &json_length);
+    printf("%.*s", (int)json_length, json);
+    yajl_gen_free(gen);
+}
+
 int main(int argc, char *argv[]) {
     socket_path = getenv("I3SOCK");
     int o, option_index = 0;
     uint32_t message_type = I3_IPC_MESSAGE_TYPE_COMMAND;
     char *payload = NULL;
     bool quiet = false;
+    bool cbor = false;
 
     static struct option long_options[] = {
         {"socket", required_argument, 0, 's'},
         {"type", required_argument, 0, 't'},
         {"version", no_argument, 0, 'v'},
         {"quiet", no_argument, 0, 'q'},
+        {"cbor", no_argument, 0, 'c'},
         {"help", no_argument, 0, 'h'},
         {0, 0, 0, 0}};
 
-    char *options_string = "s:t:vhq";
+    char *options_string = "s:t:vhqc";
 
     while ((o = getopt_long(argc, argv, options_string, long_options, &option_index)) != -1) {
         if (o == 's') {
@@ -155,19 +229,23 @@ int main(int argc, char *argv[]) {
                 message_type = I3_IPC_MESSAGE_TYPE_GET_BAR_CONFIG;
             else if (strcasecmp(optarg, "get_version") == 0)
                 message_type = I3_IPC_MESSAGE_TYPE_GET_VERSION;
+            else if (strcasecmp(optarg, "get_startup") == 0)
+                message_type = I3_IPC_MESSAGE_TYPE_GET_STARTUP;
             else {
                 printf("Unknown message type\n");
-                printf("Known types: command, get_workspaces, get_outputs, get_tree, get_marks, get_bar_config, get_version\n");
+                printf("Known types: command, get_workspaces, get_outputs, get_tree, get_marks, get_bar_config, get_version, get_startup\n");
                 exit(EXIT_FAILURE);
             }
         } else if (o == 'q') {
             quiet = true;
+        } else if (o == 'c') {
+            cbor = true;
         } else if (o == 'v') {
             printf("i3-msg " I3_VERSION "\n");
             return 0;
         } else if (o == 'h') {
             printf("i3-msg " I3_VERSION "\n");
-            printf("i3-msg [-s <socket>] [-t <type>] <message>\n");
+            printf("i3-msg [-s <socket>] [-t <type>] [-c] <message>\n");
             return 0;
         }
     }
@@ -198,6 +276,11 @@ int main(int argc, char *argv[]) {
     if (!payload)
         payload = "";
 
+    /* Only GET_TREE and GET_WORKSPACES support CBOR. i3 ignores the flag for
+     * other message types, so we just check the type of the reply. */
+    if (cbor)
+        message_type |= I3_IPC_MESSAGE_FLAG_CBOR;
+
     int sockfd = socket(AF_LOCAL, SOCK_STREAM, 0);
     if (sockfd == -1)
         err(EXIT_FAILURE, "Could not create socket");
@@ -224,6 +307,9 @@ int main(int argc, char *argv[]) {
             err(EXIT_FAILURE, "IPC: read()");
         exit(1);
     }
+    const bool cbor_reply = (reply_type & I3_IPC_MESSAGE_FLAG_CBOR);
+    reply_type &= ~I3_IPC_MESSAGE_FLAG_CBOR;
+    message_type &= ~I3_IPC_MESSAGE_FLAG_CBOR;
     if (reply_type != message_type)
         errx(EXIT_FAILURE, "IPC: Received reply of type %d but expected %d", reply_type, message_type);
     /* For the reply of commands, have a look if that command was successful.
@@ -243,7 +329,10 @@ int main(int argc, char *argv[]) {
         /* NB: We still fall-through and print the reply, because even if one
          * command failed, that doesn’t mean that all commands failed. */
     }
-    printf("%.*s\n", reply_length, reply);
+    if (cbor_reply)
+        print_cbor_reply(reply, reply_length);
+    else
+        printf("%.*s\n", reply_length, reply);
     free(reply);
 
     close(sockfd);
@@ -45,7 +45,11 @@
 
 #include "data.h"
 #include "util.h"
+#include "ipc_ring.h"
+#include "ipc_encoder.h"
 #include "ipc.h"
+#include "ipc_worker.h"
+#include "tree_snapshot.h"
 #include "tree.h"
 #include "log.h"
 #include "xcb.h"
@@ -76,6 +80,8 @@
 #include "regex.h"
 #include "libi3.h"
 #include "startup.h"
+#include "autostart.h"
+#include "timeline.h"
 #include "scratchpad.h"
 #include "commands.h"
 #include "commands_parser.h"
@@ -85,6 +91,7 @@
 #include "fake_outputs.h"
 #include "display_version.h"
 #include "restore_layout.h"
+#include "focus_index.h"
 #include "main.h"
 
 #endif
@@ -0,0 +1,51 @@
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * autostart.c: Starts the exec/exec_always lines of the config at startup,
+ *              ordered by priority and limited to exec_concurrency startups
+ *              in progress at the same time.
+ *
+ */
+#pragma once
+
+#include "ipc_encoder.h"
+
+/**
+ * Queues the exec (if run_exec is true) and exec_always lines of the config
+ * and starts as many of them as the exec_concurrency limit allows. The
+ * remaining ones are started whenever a running startup is completed.
+ *
+ */
+void autostart_run(bool run_exec);
+
+/**
+ * Called when the startup sequence of an autostarted command was completed
+ * (or deleted), which allows the next queued command to be started.
+ *
+ */
+void autostart_sequence_completed(struct Startup_Sequence *sequence);
+
+/**
+ * Called when the first window of the startup sequence of an autostarted
+ * command is managed. Records the launch-to-map latency and completes the
+ * startup of this command as far as the exec queue is concerned.
+ *
+ */
+void autostart_sequence_mapped(struct Startup_Sequence *sequence);
+
+/**
+ * Called for each newly managed window. Starts queued commands which were
+ * waiting for a window of this window’s class.
+ *
+ */
+void autostart_window_managed(i3Window *window);
+
+/**
+ * Dumps the exec queue (command, state and latencies of each autostarted
+ * command) as a JSON array, for the GET_STARTUP IPC reply.
+ *
+ */
+void autostart_dump(ipc_encoder *gen);
@@ -68,8 +68,7 @@ void binding_free(Binding *bind);
 /**
  * Runs the given binding and handles parse errors. If con is passed, it will
  * execute the command binding with that container selected by criteria.
- * Returns a CommandResult for running the binding's command. Caller should
- * render tree if needs_tree_render is true. Free with command_result_free().
+ * Renders the tree if the command requires it.
  *
  */
-CommandResult *run_binding(Binding *bind, Con *con);
+void run_binding(Binding *bind, Con *con);
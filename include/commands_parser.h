@@ -61,6 +61,17 @@ char *parse_string(const char **walk, bool as_word);
  */
 CommandResult *parse_command(const char *input, yajl_gen gen);
 
+/**
+ * Parses and executes the given command without generating a json reply and
+ * without allocating a CommandResult. Meant for commands which i3 runs itself
+ * (key bindings, for_window and assignments), where nobody reads the reply.
+ *
+ * The outcome is stored in the caller-provided 'result'. Only
+ * result->error_message (set for parse errors) needs to be freed.
+ *
+ */
+void parse_command_noreply(const char *input, CommandResult *result);
+
 /**
  * Frees a CommandResult
  */
@@ -203,6 +203,27 @@ void con_disable_fullscreen(Con *con);
  */
 void con_move_to_workspace(Con *con, Con *workspace, bool fix_coordinates, bool dont_warp);
 
+/**
+ * Begins a batch of moves: until con_move_batch_end() is called,
+ * con_move_to_workspace() keeps the focus on the currently focused workspace
+ * instead of switching workspaces for each moved container, and the "move"
+ * window events are deferred.
+ *
+ * Used by commands which move all windows matching the criteria, so that
+ * moving many windows only updates the focus (and sends the workspace events)
+ * once.
+ *
+ */
+void con_move_batch_begin(void);
+
+/**
+ * Ends a batch of moves (see con_move_batch_begin()): focuses the workspace
+ * which was focused when the batch began and sends the "move" window events
+ * for all moved containers.
+ *
+ */
+void con_move_batch_end(void);
+
 /**
  * Returns the orientation of the given container (for stacked containers,
  * vertical orientation is used regardless of the actual orientation of the
@@ -278,6 +299,13 @@ adjacent_t con_adjacent_borders(Con *con);
  */
 int con_border_style(Con *con);
 
+/**
+ * Sets the sticky group of the given container (NULL removes it from its
+ * group) and keeps the registry of sticky groups up to date.
+ *
+ */
+void con_set_sticky_group(Con *con, const char *sticky_group);
+
 /**
  * Sets the given border style on con, correctly keeping the position/size of a
  * floating window.
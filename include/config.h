@@ -141,6 +141,12 @@ struct Config {
      * more often. */
     bool force_focus_wrapping;
 
+    /** By default, 'focus left|right|up|down' walks the tree from the
+     * focused container. With DIRECTIONAL_FOCUS_GEOMETRIC, i3 instead picks
+     * the nearest container in that direction on the workspace, based on
+     * where the containers were rendered. */
+    directional_focus_t directional_focus;
+
     /** By default, use the RandR API for multi-monitor setups.
      * Unfortunately, the nVidia binary graphics driver doesn't support
      * this API. Instead, it only support the less powerful Xinerama API,
@@ -159,10 +165,24 @@ struct Config {
      * previously focused one instead, making it possible to fast toggle
      * between two workspaces. */
     bool workspace_auto_back_and_forth;
+
+    /** Memory budget (in MiB) for keeping recently used hidden workspaces
+     * rendered, so that switching to them only needs to map their windows.
+     * 0 disables pre-warming. */
+    int workspace_prewarm;
     
     /** The default floating window edge snap threshold */
     int snap_threshold;
 
+    /** Maximum number of exec/exec_always commands whose startup is in
+     * progress at the same time when starting i3. 0 means no limit. */
+    int exec_concurrency;
+
+    /** Defer work which is not needed for the first frame (setting the
+     * desktop names, starting bars and exec/exec_always commands) until the
+     * first frame was pushed to the X server. */
+    bool fast_start;
+
     /** By default, urgency is cleared immediately when switching to another
      * workspace leads to focusing the con with the urgency hint. When having
      * multiple windows on that workspace, the user needs to guess which
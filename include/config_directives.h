@@ -38,7 +38,9 @@ CFGFUN(criteria_add, const char *ctype, const char *cvalue);
 CFGFUN(criteria_pop_state);
 
 CFGFUN(font, const char *font);
-CFGFUN(exec, const char *exectype, const char *no_startup_id, const char *command);
+CFGFUN(exec, const char *exectype, const char *no_startup_id, const long priority, const char *wait_for_class, const char *command);
+CFGFUN(fast_start, const char *value);
+CFGFUN(exec_concurrency, const long limit);
 CFGFUN(for_window, const char *command);
 CFGFUN(snap_threshold, const long snap_threshold);
 CFGFUN(floating_minimum_size, const long width, const long height);
@@ -46,9 +48,11 @@ CFGFUN(floating_maximum_size, const long width, const long height);
 CFGFUN(default_orientation, const char *orientation);
 CFGFUN(workspace_layout, const char *layout);
 CFGFUN(workspace_back_and_forth, const char *value);
+CFGFUN(workspace_prewarm, const long budget_mb);
 CFGFUN(focus_follows_mouse, const char *value);
 CFGFUN(mouse_warping, const char *value);
 CFGFUN(force_focus_wrapping, const char *value);
+CFGFUN(directional_focus, const char *value);
 CFGFUN(force_xinerama, const char *value);
 CFGFUN(fake_outputs, const char *outputs);
 CFGFUN(force_display_urgency_hint, const long duration_ms);
@@ -115,6 +115,14 @@ typedef enum {
     POINTER_WARPING_NONE = 1
 } warping_t;
 
+/**
+ * How 'focus left|right|up|down' finds the container to focus.
+ */
+typedef enum {
+    DIRECTIONAL_FOCUS_TREE = 0,
+    DIRECTIONAL_FOCUS_GEOMETRIC = 1
+} directional_focus_t;
+
 /**
  * Stores a rectangle, for example the size of a window, the child window etc.
  * It needs to be packed so that the compiler will not add any padding bytes.
@@ -186,6 +194,9 @@ struct Workspace_Assignment {
 
 struct Ignore_Event {
     int sequence;
+    /* last sequence number of the ignored range (equal to sequence when
+     * only a single sequence number is ignored) */
+    int last_sequence;
     int response_type;
     time_t added;
 
@@ -207,8 +218,27 @@ struct Startup_Sequence {
     /** time at which this sequence should be deleted (after it was marked as
      * completed) */
     time_t delete_at;
+    /** autostart which initiated this sequence, if any (see
+     * src/autostart.c) */
+    struct Autostart *autostart;
 
     TAILQ_ENTRY(Startup_Sequence) sequences;
+    /** entry in the bucket of the startup sequence index (by id) */
+    LIST_ENTRY(Startup_Sequence) by_id;
+};
+
+/**
+ * All containers which share the same sticky_group. Used to find the
+ * container which currently holds the group’s window without walking the
+ * tree (see workspace_reassign_sticky()).
+ *
+ */
+struct Sticky_Group {
+    char *name;
+
+    TAILQ_HEAD(sticky_cons_head, Con) cons_head;
+
+    TAILQ_ENTRY(Sticky_Group) sticky_groups;
 };
 
 /**
@@ -299,8 +329,28 @@ struct Autostart {
     /** no_startup_id flag for start_application(). Determines whether a
      * startup notification context/ID should be created. */
     bool no_startup_id;
+    /** Autostarts with a higher priority are started first when the number
+     * of concurrent startups is limited (see exec_concurrency). */
+    long priority;
+    /** If set, the command is only started once a window with this WM_CLASS
+     * class is managed (or waiting for it timed out). */
+    char *wait_for_class;
+
+    /** Where this autostart is in the exec queue (see src/autostart.c). */
+    enum {
+        AS_QUEUED = 0,
+        AS_RUNNING = 1,
+        AS_DONE = 2
+    } state;
+    /** ev_time() at which the command was started and at which the first
+     * window of its startup sequence was managed (0 if that did not happen
+     * yet). */
+    double started_at;
+    double mapped_at;
+
     TAILQ_ENTRY(Autostart) autostarts;
     TAILQ_ENTRY(Autostart) autostarts_always;
+    TAILQ_ENTRY(Autostart) exec_queue;
 };
 
 /**
@@ -333,6 +383,16 @@ struct xoutput {
     /** x, y, width, height */
     Rect rect;
 
+    /** Position of this output in the outputs list, used to pick the same
+     * output as a linear search would when outputs overlap. Only valid while
+     * the output index is (see randr_update_output_index()). */
+    int position;
+
+    /** The next outputs in each direction (indexed by direction_t), closest
+     * and farthest (indexed by output_close_far_t), as get_output_next()
+     * would return them. Precomputed by randr_update_output_index(). */
+    Output *neighbors[4][2];
+
     TAILQ_ENTRY(xoutput) outputs;
 };
 
@@ -391,6 +451,11 @@ struct Window {
 
     /** Depth of the window */
     uint16_t depth;
+
+    /** The _NET_WM_DESKTOP and _NET_WM_STATE (WM_STATE_* bits) which i3 last
+     * wrote to this window, see ewmh_flush_hints(). */
+    uint32_t wm_desktop;
+    int wm_state;
 };
 
 /**
@@ -496,6 +561,17 @@ typedef enum { CF_NONE = 0,
 struct Con {
     bool mapped;
 
+    /* Set for the containers of hidden workspaces which were rendered so that
+     * showing them is fast (see workspace_prewarm()). */
+    bool prewarmed;
+    /* Set on workspaces whose children changed since they were last
+     * pre-warmed. */
+    bool prewarm_dirty;
+
+    /* Set while the window of this container is being killed by
+     * tree_close_many() and has not gone away yet. */
+    bool bulk_close;
+
     /* Should this container be marked urgent? This gets set when the window
      * inside this container (if any) sets the urgency hint, for example. */
     bool urgent;
@@ -540,6 +616,17 @@ struct Con {
      * group. The contents are shared between all of them, that is they are
      * displayed on whichever of the containers is currently visible */
     char *sticky_group;
+    /* the registry entry for sticky_group, see con_set_sticky_group() */
+    struct Sticky_Group *sticky;
+
+    /* Only for workspaces: the rects of the tiling containers on this
+     * workspace as of the last render, for 'directional_focus geometric'
+     * (see focus_index_update()). */
+    struct focus_index *focus_index;
+
+    /* Whether this container is queued for an update of the EWMH hints of
+     * its window (see ewmh_update_window_hints()). */
+    bool ewmh_pending;
 
     /* user-definable mark to jump to this container later */
     char *mark;
@@ -611,6 +698,9 @@ struct Con {
     TAILQ_ENTRY(Con) focused;
     TAILQ_ENTRY(Con) all_cons;
     TAILQ_ENTRY(Con) floating_windows;
+    TAILQ_ENTRY(Con) sticky_cons;
+    TAILQ_ENTRY(Con) scratchpad_windows;
+    TAILQ_ENTRY(Con) ewmh_pending_cons;
 
     /** callbacks */
     void (*on_remove_child)(Con *);
@@ -627,6 +717,10 @@ struct Con {
         SCRATCHPAD_CHANGED = 2
     } scratchpad_state;
 
+    /* Whether this scratchpad window is in the list of shown scratchpad
+     * windows, see scratchpad_update(). */
+    bool scratchpad_shown;
+
     /* The ID of this container before restarting. Necessary to correctly
      * interpret back-references in the JSON (such as the focus stack). */
     int old_id;
@@ -0,0 +1,18 @@
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * encoder_utils.h: The y() and ystr() shortcuts of yajl_utils.h, but for the
+ *                  ipc_encoder_* functions. When both are needed, include
+ *                  this one after yajl_utils.h.
+ *
+ */
+#pragma once
+
+#undef y
+#undef ystr
+
+#define y(x, ...) ipc_encoder_##x(gen, ##__VA_ARGS__)
+#define ystr(str) ipc_encoder_string(gen, (unsigned char *)str, strlen(str))
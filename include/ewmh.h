@@ -9,12 +9,23 @@
  */
 #pragma once
 
+/* _NET_WM_DESKTOP of windows which are not on a (non-internal) workspace, e.g.
+ * dock clients and scratchpad windows. The property is deleted for those. */
+#define NET_WM_DESKTOP_NONE 0xFFFFFFF0
+
+/* Bits of i3Window.wm_state, the _NET_WM_STATE which i3 last wrote. */
+#define WM_STATE_FULLSCREEN (1 << 0)
+#define WM_STATE_DEMANDS_ATTENTION (1 << 1)
+
 /**
  * Updates _NET_CURRENT_DESKTOP with the current desktop number.
  *
  * EWMH: The index of the current desktop. This is always an integer between 0
  * and _NET_NUMBER_OF_DESKTOPS - 1.
  *
+ * Like the other desktop hints, the property is only written by the next
+ * ewmh_flush_hints() and only if its value changed.
+ *
  */
 void ewmh_update_current_desktop(void);
 
@@ -36,6 +47,32 @@ void ewmh_update_desktop_names(void);
  */
 void ewmh_update_desktop_viewport(void);
 
+/**
+ * Marks the windows of the given container and all of its children for an
+ * update of _NET_WM_DESKTOP and _NET_WM_STATE by the next ewmh_flush_hints().
+ * Called whenever a container is attached somewhere else or its fullscreen
+ * mode or urgency changes. Windows whose hints did not change are not written.
+ *
+ */
+void ewmh_update_window_hints(Con *con);
+
+/**
+ * Removes the given container from the pending window hint updates. Called
+ * before the container is freed.
+ *
+ */
+void ewmh_forget_con(Con *con);
+
+/**
+ * Writes the desktop hints and the per-window hints which were updated since
+ * the last call, skipping those whose value did not change. Called once per
+ * event loop iteration (before flushing the X11 connection), so that a
+ * command which switches through several workspaces or moves several windows
+ * results in at most one write of each property.
+ *
+ */
+void ewmh_flush_hints(void);
+
 /**
  * Updates _NET_ACTIVE_WINDOW with the currently focused window.
  *
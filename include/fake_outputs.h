@@ -16,5 +16,9 @@
  * with multiple outputs separated by commas:
  *   1900x1200+0+0,1280x1024+1900+0
  *
+ * A grid of equally sized outputs can be specified as colsxrows@wxh, for
+ * example 4x4@3840x2160 for a video wall of 16 4K outputs. The outputs of a
+ * grid are named row by row, starting at the top left.
+ *
  */
 void fake_outputs_init(const char *output_spec);
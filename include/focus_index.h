@@ -0,0 +1,43 @@
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * focus_index.c: Per-workspace index of the rendered tiling containers, used
+ *                to find the nearest container in a direction for
+ *                'directional_focus geometric'.
+ *
+ */
+#pragma once
+
+/**
+ * (Re-)builds the focus index of the given workspace from the rects of its
+ * tiling containers. Called after the workspace was rendered.
+ *
+ */
+void focus_index_update(Con *ws);
+
+/**
+ * Marks the focus index of the workspace containing the given container as
+ * outdated, so that it will not be used until the next render. Called
+ * whenever containers are attached to or detached from a workspace.
+ *
+ */
+void focus_index_invalidate(Con *con);
+
+/**
+ * Frees the focus index of the given workspace (if any).
+ *
+ */
+void focus_index_free(Con *ws);
+
+/**
+ * Returns the container which is nearest to the given one in the given
+ * direction on the same workspace, or NULL if there is none or the index
+ * cannot answer (e.g. for floating containers, containers inside a stacked
+ * or tabbed container or when the index is outdated). In the latter cases,
+ * the caller falls back to walking the tree.
+ *
+ */
+Con *focus_index_next(Con *con, direction_t direction);
@@ -25,6 +25,15 @@ extern int xkb_base;
  */
 void add_ignore_event(const int sequence, const int response_type);
 
+/**
+ * Like add_ignore_event(), but ignores all events with a sequence number
+ * between first and last (inclusive). Events carry the sequence number of
+ * the last request the X server processed before generating them, so this
+ * ignores all events caused by the requests sent in between.
+ *
+ */
+void add_ignore_event_range(const int first, const int last, const int response_type);
+
 /**
  * Checks if the given sequence is ignored and returns true if so.
  *
@@ -51,6 +51,18 @@ typedef struct i3_ipc_header {
 /** Request the i3 version */
 #define I3_IPC_MESSAGE_TYPE_GET_VERSION 7
 
+/** Request the state of the autostarted commands */
+#define I3_IPC_MESSAGE_TYPE_GET_STARTUP 8
+
+/** Subscribe to the specified events, delivered through a shared memory ring
+ * buffer instead of the socket */
+#define I3_IPC_MESSAGE_TYPE_SUBSCRIBE_RING 9
+
+/** Set in the message type of GET_TREE and GET_WORKSPACES requests to receive
+ * the reply encoded as CBOR (RFC 7049) instead of JSON. The reply type has
+ * this flag set if (and only if) the reply is CBOR-encoded. */
+#define I3_IPC_MESSAGE_FLAG_CBOR (1 << 30)
+
 /*
  * Messages from i3 to clients
  *
@@ -80,6 +92,12 @@ typedef struct i3_ipc_header {
 /** i3 version reply type */
 #define I3_IPC_REPLY_TYPE_VERSION 7
 
+/** Startup reply type */
+#define I3_IPC_REPLY_TYPE_STARTUP 8
+
+/** Ring subscription reply type */
+#define I3_IPC_REPLY_TYPE_SUBSCRIBE_RING 9
+
 /*
  * Events from i3 to clients. Events have the first bit set high.
  *
@@ -103,3 +121,45 @@ typedef struct i3_ipc_header {
 
 /** The binding event will be triggered when bindings run */
 #define I3_IPC_EVENT_BINDING (I3_IPC_EVENT_MASK | 5)
+
+/** Sent over the socket (without payload) to clients with a ring buffer when
+ * new events were written to it after the client had consumed all previous
+ * ones */
+#define I3_IPC_EVENT_RING_WAKEUP (I3_IPC_EVENT_MASK | 6)
+
+/*
+ * The shared memory ring buffer for SUBSCRIBE_RING (see docs/ipc). It starts
+ * with this header, followed by the data area of the given size. The data
+ * area contains records (i3_ipc_ring_record_t followed by the payload), each
+ * padded to a multiple of 8 bytes.
+ *
+ */
+
+/** Never change this, only on incompatible changes of the ring layout */
+#define I3_IPC_RING_MAGIC "i3-ring1"
+
+typedef struct i3_ipc_ring_header {
+    /* 8 = strlen(I3_IPC_RING_MAGIC) */
+    char magic[8];
+    /* Size of the data area in bytes (a multiple of 8). */
+    uint32_t size;
+    uint32_t reserved;
+    /* Number of bytes written by i3 since the ring was created. The write
+     * position within the data area is write_offset % size. Only modified by
+     * i3. */
+    uint64_t write_offset;
+    /* Number of bytes consumed by the client. Only modified by the client,
+     * i3 does not overwrite records which were not consumed yet. */
+    uint64_t read_offset;
+    /* Number of events which were dropped because the ring was full. */
+    uint64_t dropped;
+} i3_ipc_ring_header_t;
+
+typedef struct i3_ipc_ring_record {
+    /* The event type (e.g. I3_IPC_EVENT_WINDOW) or 0 for a record which only
+     * pads the rest of the data area, after which the next record starts at
+     * the beginning of the data area. */
+    uint32_t type;
+    /* Size of the payload following this record. */
+    uint32_t size;
+} i3_ipc_ring_record_t;
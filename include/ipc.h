@@ -19,6 +19,8 @@
 #include "config.h"
 
 #include "i3/ipc.h"
+#include "ipc_ring.h"
+#include "ipc_encoder.h"
 
 extern char *current_socketpath;
 
@@ -28,6 +30,29 @@ typedef struct ipc_client {
     /* The events which this client wants to receive */
     int num_events;
     char **events;
+    /* For each entry in events, whether the client subscribed to the compact
+     * flavor (only ids, names and geometry instead of full containers) */
+    bool *compact_events;
+    /* For each entry in events, whether the client wants to receive every
+     * event, including those superseded by later ones (see
+     * ipc_flush_events()) */
+    bool *all_events;
+
+    /* If the client subscribed with SUBSCRIBE_RING, its events are written to
+     * this ring buffer instead of the socket */
+    ipc_ring *ring;
+
+    /* The watcher for messages from this client. It is stopped while a
+     * worker thread writes a reply (see ipc_worker.c), so that the replies
+     * are sent in the order of the requests. */
+    struct ev_io *callback;
+
+    /* Set while a worker thread writes a reply to this client. Messages
+     * which are sent to the client in the meantime (i.e. events) are
+     * appended to queued_output. */
+    bool reply_pending;
+    char *queued_output;
+    size_t queued_output_length;
 
     TAILQ_ENTRY(ipc_client) clients;
 } ipc_client;
@@ -73,12 +98,57 @@ void ipc_new_client(EV_P_ struct ev_io *w, int revents);
 int ipc_create_socket(const char *filename);
 
 /**
- * Sends the specified event to all IPC clients which are currently connected
- * and subscribed to this kind of event.
+ * Queues the specified event for all IPC clients which are subscribed to this
+ * kind of event. It is sent by the next ipc_flush_events().
  *
  */
 void ipc_send_event(const char *event, uint32_t message_type, const char *payload);
 
+/**
+ * Returns true if at least one IPC client is subscribed to the given event
+ * with the given flavor (compact or full payload).
+ *
+ */
+bool ipc_has_event_subscribers(const char *event, bool compact);
+
+/**
+ * Queues the payloads of the given encoders for all IPC clients subscribed
+ * to the event: clients which subscribed to the compact flavor get the payload
+ * of compact_gen, all others get the payload of gen. Either encoder may be
+ * NULL if nobody wants that flavor. Frees both encoders.
+ *
+ */
+void ipc_send_marshalled_event(const char *event, uint32_t message_type, ipc_encoder *gen, ipc_encoder *compact_gen);
+
+/**
+ * Sends all queued events to the subscribed clients, in the order in which
+ * they were emitted. Superseded events are skipped, unless the client asked
+ * for every event (by subscribing to e.g. "window:all").
+ *
+ */
+void ipc_flush_events(void);
+
+/**
+ * Generates the payloads of all queued events which refer to the given
+ * container, because it is about to be freed. Called by tree_close().
+ *
+ */
+void ipc_forget_con(Con *con);
+
+/**
+ * Called once a worker thread finished writing a reply to the client: sends
+ * the messages which were queued in the meantime and resumes reading
+ * messages from the client.
+ *
+ */
+void ipc_client_resume(ipc_client *client);
+
+/**
+ * Closes the connection to the given client and frees it.
+ *
+ */
+void ipc_client_disconnect(ipc_client *client);
+
 /**
  * Calls shutdown() on each socket and closes it. This function to be called
  * when exiting or restarting only!
@@ -86,24 +156,31 @@ void ipc_send_event(const char *event, uint32_t message_type, const char *payloa
  */
 void ipc_shutdown(void);
 
-void dump_node(yajl_gen gen, Con *con, bool inplace_restart);
+void dump_node(ipc_encoder *gen, Con *con, bool inplace_restart);
 
 /**
- * Generates a json workspace event. Returns a dynamically allocated yajl
- * generator. Free with yajl_gen_free().
+ * Generates a json workspace event. Returns a dynamically allocated JSON
+ * encoder. Free with ipc_encoder_free().
+ *
+ * When compact is true, the workspaces are not serialized with dump_node(),
+ * only their id, name, num and rect are included.
  */
-yajl_gen ipc_marshal_workspace_event(const char *change, Con *current, Con *old);
+ipc_encoder *ipc_marshal_workspace_event(const char *change, Con *current, Con *old, bool compact);
 
 /**
  * For the workspace events we send, along with the usual "change" field, also
  * the workspace container in "current". For focus events, we send the
  * previously focused workspace in "old".
+ *
+ * The event is queued and serialized when it is sent, see ipc_flush_events().
  */
 void ipc_send_workspace_event(const char *change, Con *current, Con *old);
 
 /**
  * For the window events we send, along the usual "change" field,
  * also the window container, in "container".
+ *
+ * The event is queued and serialized when it is sent, see ipc_flush_events().
  */
 void ipc_send_window_event(const char *property, Con *con);
 
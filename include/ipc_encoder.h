@@ -0,0 +1,76 @@
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * ipc_encoder.c: Generates IPC payloads either as JSON (using yajl) or as
+ *                CBOR, so that the same dump functions serve both encodings.
+ *
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum {
+    IPC_ENCODING_JSON = 0,
+    IPC_ENCODING_CBOR = 1
+} ipc_encoding_t;
+
+typedef struct ipc_encoder ipc_encoder;
+
+/**
+ * Creates a new encoder which generates the given encoding.
+ *
+ */
+ipc_encoder *ipc_encoder_new(ipc_encoding_t encoding);
+
+/**
+ * Returns the encoding which the given encoder generates.
+ *
+ */
+ipc_encoding_t ipc_encoder_encoding(ipc_encoder *encoder);
+
+/*
+ * The following functions correspond to the yajl_gen_* functions of the same
+ * name. Together with encoder_utils.h, the y() and ystr() macros can be used
+ * just like with yajl.
+ *
+ */
+void ipc_encoder_map_open(ipc_encoder *encoder);
+void ipc_encoder_map_close(ipc_encoder *encoder);
+void ipc_encoder_array_open(ipc_encoder *encoder);
+void ipc_encoder_array_close(ipc_encoder *encoder);
+void ipc_encoder_null(ipc_encoder *encoder);
+void ipc_encoder_bool(ipc_encoder *encoder, bool value);
+void ipc_encoder_integer(ipc_encoder *encoder, long long value);
+void ipc_encoder_double(ipc_encoder *encoder, double value);
+void ipc_encoder_string(ipc_encoder *encoder, const unsigned char *str, size_t length);
+
+/**
+ * Inserts the given number verbatim (for JSON). For CBOR, it is parsed and
+ * encoded as an integer or a double.
+ *
+ */
+void ipc_encoder_number(ipc_encoder *encoder, const char *number, size_t length);
+
+/**
+ * Appends the item contained in the given CBOR data (e.g. a snapshot of the
+ * tree) to the encoder, converting it to JSON if necessary. Returns false if
+ * the data is malformed.
+ *
+ */
+bool ipc_encoder_append_cbor(ipc_encoder *encoder, const unsigned char *data, size_t length);
+
+/**
+ * Returns the generated payload. It remains valid until the encoder is freed.
+ *
+ */
+void ipc_encoder_get_buf(ipc_encoder *encoder, const unsigned char **buf, size_t *length);
+
+/**
+ * Frees the encoder and its payload.
+ *
+ */
+void ipc_encoder_free(ipc_encoder *encoder);
@@ -0,0 +1,58 @@
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * ipc_ring.c: Shared memory ring buffers through which IPC events are
+ *             delivered to clients which subscribed with SUBSCRIBE_RING.
+ *
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct ipc_ring ipc_ring;
+
+/**
+ * Creates a new ring buffer in a POSIX shared memory object. Returns NULL if
+ * that failed.
+ *
+ */
+ipc_ring *ipc_ring_new(void);
+
+/**
+ * Returns the name of the shared memory object of the given ring (to be
+ * opened by the client with shm_open()).
+ *
+ */
+const char *ipc_ring_name(ipc_ring *ring);
+
+/**
+ * Returns the size of the data area of the given ring.
+ *
+ */
+uint32_t ipc_ring_size(ipc_ring *ring);
+
+/**
+ * Appends an event to the ring. If the client did not consume enough of the
+ * previous events to make room for it, the event is dropped (and counted in
+ * the header). Returns whether the event was written.
+ *
+ */
+bool ipc_ring_write(ipc_ring *ring, uint32_t type, const char *payload, uint32_t size);
+
+/**
+ * Ends a batch of ipc_ring_write() calls. Returns true if events were written
+ * and the client had consumed all events before them, i.e. it might be
+ * waiting for a wakeup on the socket.
+ *
+ */
+bool ipc_ring_end_batch(ipc_ring *ring);
+
+/**
+ * Unmaps and unlinks the ring buffer and frees it.
+ *
+ */
+void ipc_ring_free(ipc_ring *ring);
@@ -0,0 +1,35 @@
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * ipc_worker.c: Converts GET_TREE replies to JSON and writes them to the
+ *               client on worker threads, so that large trees do not block
+ *               the event loop.
+ *
+ */
+#pragma once
+
+#include "ipc.h"
+#include "ipc_encoder.h"
+#include "tree_snapshot.h"
+
+/**
+ * Sends the GET_TREE reply to the given client. The CBOR-encoded tree is
+ * taken either from snapshot or (for subtrees) from dump, the other one is
+ * NULL. It is converted to JSON unless the client requested CBOR. Large
+ * replies are converted and written on a worker thread, during which no
+ * further messages are read from the client. Takes ownership of the snapshot
+ * reference or the dump.
+ *
+ */
+void ipc_worker_send_tree(ipc_client *client, tree_snapshot *snapshot, ipc_encoder *dump,
+                          ipc_encoding_t encoding);
+
+/**
+ * Waits for all worker threads. Called by ipc_shutdown() after shutting down
+ * the client sockets.
+ *
+ */
+void ipc_worker_shutdown(void);
@@ -274,6 +274,36 @@ int ipc_send_message(int sockfd, const uint32_t message_size,
 int ipc_recv_message(int sockfd, uint32_t *message_type,
                      uint32_t *reply_length, uint8_t **reply);
 
+/**
+ * Callbacks for cbor_parse(). They have the same signatures as the
+ * corresponding yajl_callbacks, so that the callbacks used to parse JSON
+ * replies can be reused. Returning 0 cancels parsing. Callbacks which are
+ * NULL are skipped.
+ *
+ */
+typedef struct cbor_callbacks {
+    int (*cbor_null)(void *ctx);
+    int (*cbor_boolean)(void *ctx, int value);
+    int (*cbor_integer)(void *ctx, long long value);
+    int (*cbor_double)(void *ctx, double value);
+    int (*cbor_string)(void *ctx, const unsigned char *value, size_t length);
+    int (*cbor_start_map)(void *ctx);
+    int (*cbor_map_key)(void *ctx, const unsigned char *key, size_t length);
+    int (*cbor_end_map)(void *ctx);
+    int (*cbor_start_array)(void *ctx);
+    int (*cbor_end_array)(void *ctx);
+} cbor_callbacks;
+
+/**
+ * Parses a CBOR-encoded reply (see I3_IPC_MESSAGE_FLAG_CBOR) and calls the
+ * given callbacks for each item, like yajl_parse() does for JSON.
+ *
+ * Returns false if the reply is malformed or a callback canceled parsing.
+ *
+ */
+bool cbor_parse(const unsigned char *data, size_t length,
+                const cbor_callbacks *callbacks, void *ctx);
+
 /**
  * Generates a configure_notify event and sends it to the given window
  * Applications need this to think they’ve configured themselves correctly.
@@ -336,6 +366,10 @@ uint32_t get_mod_mask_for(uint32_t keysym,
  * the fonts 'fixed' or '-misc-*' will be loaded instead of exiting. If any
  * font was previously loaded, it will be freed.
  *
+ * Fonts are cached for the lifetime of the process, so loading the same
+ * pattern again (e.g. when reloading the config) does not talk to the X
+ * server or Pango.
+ *
  */
 i3Font load_font(const char *pattern, const bool fallback);
 
@@ -352,6 +386,23 @@ void set_font(i3Font *font);
  */
 void free_font(void);
 
+/**
+ * Saves the metrics of all cached fonts (the font heights and, for X core
+ * fonts, the QueryFont replies including the per-glyph tables) to the given
+ * file, so that they can be restored with font_cache_restore() after an
+ * in-place restart. Returns true on success.
+ *
+ */
+bool font_cache_save(const char *path);
+
+/**
+ * Restores the fonts saved by font_cache_save(), so that loading them again
+ * neither needs to query the X server for their metrics nor to measure them
+ * with Pango. Returns true if the file could be read.
+ *
+ */
+bool font_cache_restore(const char *path);
+
 /**
  * Converts the given string to UTF-8 from UCS-2 big endian. The return value
  * must be freed after use.
@@ -64,8 +64,12 @@ void init_ws_for_output(Output *output, Con *content);
 /**
  * (Re-)queries the outputs via RandR and stores them in the list of outputs.
  *
+ * Only the outputs which were added, removed or changed (mode, position or
+ * primary) are updated in the tree. Returns false if nothing changed at all,
+ * in which case the tree is neither changed nor rendered.
+ *
  */
-void randr_query_outputs(void);
+bool randr_query_outputs(void);
 
 /**
  * Returns the first output which is active.
@@ -96,6 +100,15 @@ Output *get_output_containing(unsigned int x, unsigned int y);
  */
 bool contained_by_output(Rect rect);
 
+/**
+ * Rebuilds the index of the active outputs (sorted by x coordinate, with the
+ * neighbors of each output precomputed), which get_output_containing() and
+ * get_output_next() use instead of comparing all outputs. Needs to be called
+ * whenever outputs are added, removed or changed.
+ *
+ */
+void randr_update_output_index(void);
+
 /**
  * Gets the output which is the next one in the given direction.
  *
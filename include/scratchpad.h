@@ -38,3 +38,11 @@ void scratchpad_show(Con *con);
  *
  */
 void scratchpad_fix_resolution(void);
+
+/**
+ * Updates the list of shown scratchpad windows after the given floating
+ * container was attached to a workspace (or closed, if closing is true).
+ * Scratchpad windows which are not on __i3_scratch are considered shown.
+ *
+ */
+void scratchpad_update(Con *con, bool closing);
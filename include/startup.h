@@ -27,8 +27,11 @@
  * The no_startup_id flag determines whether a startup notification context
  * (and ID) should be created, which is the default and encouraged behavior.
  *
+ * Returns the startup sequence which was created for this application, or
+ * NULL if no_startup_id was set.
+ *
  */
-void start_application(const char *command, bool no_startup_id);
+struct Startup_Sequence *start_application(const char *command, bool no_startup_id);
 
 /**
  * Deletes a startup sequence, ignoring whether its timeout has elapsed.
@@ -50,12 +53,29 @@ void startup_monitor_event(SnMonitorEvent *event, void *userdata);
  */
 void startup_sequence_rename_workspace(char *old_name, char *new_name);
 
+/**
+ * Requests the _NET_STARTUP_ID of the given window’s leader (if it has one and
+ * the window itself has no _NET_STARTUP_ID) without waiting for the reply, so
+ * that the request can be pipelined with other requests. The reply needs to be
+ * passed to startup_sequence_get().
+ *
+ * Returns a cookie with sequence number 0 if the request is not necessary.
+ *
+ */
+xcb_get_property_cookie_t startup_leader_startup_id(i3Window *cwindow, xcb_get_property_reply_t *startup_id_reply);
+
 /**
  * Gets the stored startup sequence for the _NET_STARTUP_ID of a given window.
  *
+ * If the window has no _NET_STARTUP_ID, the one of its leader is used, which
+ * is passed in leader_startup_id_reply (see startup_leader_startup_id()). Both
+ * replies are freed.
+ *
  */
 struct Startup_Sequence *startup_sequence_get(i3Window *cwindow,
-                                              xcb_get_property_reply_t *startup_id_reply, bool ignore_mapped_leader);
+                                              xcb_get_property_reply_t *startup_id_reply,
+                                              xcb_get_property_reply_t *leader_startup_id_reply,
+                                              bool ignore_mapped_leader);
 
 /**
  * Checks if the given window belongs to a startup notification by checking if
@@ -65,5 +85,9 @@ struct Startup_Sequence *startup_sequence_get(i3Window *cwindow,
  * If so, returns the workspace on which the startup was initiated.
  * Returns NULL otherwise.
  *
+ * Since this is called for every newly managed window, it also lets the exec
+ * queue know about the first window of an autostarted command.
+ *
  */
-char *startup_workspace_for_window(i3Window *cwindow, xcb_get_property_reply_t *startup_id_reply);
+char *startup_workspace_for_window(i3Window *cwindow, xcb_get_property_reply_t *startup_id_reply,
+                                   xcb_get_property_reply_t *leader_startup_id_reply);
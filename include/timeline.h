@@ -0,0 +1,41 @@
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * timeline.c: Records how long the phases of i3’s startup take (connecting to
+ *             X, parsing the config, initializing the outputs, …).
+ *
+ */
+#pragma once
+
+#include "ipc_encoder.h"
+
+/**
+ * Records the beginning of the given startup phase. The name is not copied and
+ * thus needs to be a string literal.
+ *
+ */
+void timeline_begin(const char *phase);
+
+/**
+ * Records the end of the given startup phase and logs its duration. If the
+ * phase was not begun, it is recorded as a point in time.
+ *
+ */
+void timeline_end(const char *phase);
+
+/**
+ * Stops recording startup phases. Called once the first frame was pushed to
+ * the X server, so that later config reloads do not show up in the timeline.
+ *
+ */
+void timeline_finish(void);
+
+/**
+ * Dumps the recorded startup phases as a JSON array, for the GET_STARTUP IPC
+ * reply.
+ *
+ */
+void timeline_dump(ipc_encoder *gen);
@@ -56,6 +56,24 @@ bool level_down(void);
  */
 void tree_render(void);
 
+/**
+ * Returns true if the given container was killed by tree_close_many() and
+ * other windows of the same bulk close are still open. Closing it does not
+ * need to render the tree then, as the tree will be rendered once the last of
+ * these windows is gone.
+ *
+ */
+bool tree_close_defers_render(Con *con);
+
+/**
+ * Closes all the given containers, like calling tree_close() for each of them.
+ * The kill requests for all windows are sent in one batch, and the tree is
+ * rendered only once, when the last of these windows is gone, instead of once
+ * per window.
+ *
+ */
+void tree_close_many(Con **cons, int num, kill_window_t kill_window);
+
 /**
  * Closes the current container using tree_close().
  *
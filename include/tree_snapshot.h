@@ -0,0 +1,77 @@
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * tree_snapshot.c: Immutable, versioned snapshots of the layout tree which
+ *                  can be read while (or after) the live tree is modified.
+ *
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ipc_encoder.h"
+
+typedef struct tree_snapshot tree_snapshot;
+
+/**
+ * Keeps the HISTORY_SIZE most recent snapshots instead of only the latest
+ * one, so that they can be saved after a crash. Enabled by --tree-history.
+ *
+ */
+void tree_snapshot_enable_history(void);
+
+/**
+ * Marks the latest snapshot as outdated. Called before anything which might
+ * modify the tree is done, i.e. before handling X11 events and commands, and
+ * by x_push_changes() (renders triggered by timers).
+ *
+ */
+void tree_snapshot_invalidate(void);
+
+/**
+ * Returns a reference to a snapshot of the current tree. The latest snapshot
+ * is reused unless it is outdated, otherwise a new one is taken. Release the
+ * reference with tree_snapshot_unref().
+ *
+ */
+tree_snapshot *tree_snapshot_take(void);
+
+/**
+ * Acquires a reference to the given snapshot. Snapshots are never modified,
+ * so they may be passed to other threads.
+ *
+ */
+tree_snapshot *tree_snapshot_ref(tree_snapshot *snapshot);
+
+/**
+ * Releases a reference to the given snapshot, freeing it once the last
+ * reference is gone.
+ *
+ */
+void tree_snapshot_unref(tree_snapshot *snapshot);
+
+/**
+ * Returns the version of the given snapshot. Versions increase with every
+ * snapshot that is taken.
+ *
+ */
+uint64_t tree_snapshot_version(tree_snapshot *snapshot);
+
+/**
+ * Returns the tree contained in the given snapshot, in the CBOR encoding of
+ * dump_node() (as sent for GET_TREE). It remains valid as long as the
+ * reference is held.
+ *
+ */
+void tree_snapshot_get_layout(tree_snapshot *snapshot, const unsigned char **buf, size_t *length);
+
+/**
+ * Writes the kept snapshots (oldest first) as a JSON array to the given file.
+ * Returns false on errors.
+ *
+ */
+bool tree_snapshot_dump_history(const char *filename);
@@ -14,6 +14,10 @@
 #include "tree.h"
 #include "randr.h"
 
+/* All sticky groups which contain at least one container */
+TAILQ_HEAD(sticky_groups_head, Sticky_Group);
+extern struct sticky_groups_head sticky_groups;
+
 /**
  * Returns a pointer to the workspace with the given number (starting at 0),
  * creating the workspace if necessary (by allocating the necessary amount of
@@ -100,6 +104,31 @@ void workspace_back_and_forth(void);
  */
 Con *workspace_back_and_forth_get(void);
 
+/**
+ * Renames the given workspace in the workspace history, so that it is still
+ * pre-warmed after “rename workspace”.
+ *
+ */
+void workspace_history_rename(const char *old_name, const char *new_name);
+
+/**
+ * Renders the most recently shown hidden workspaces (as long as their
+ * pixmaps fit into the workspace_prewarm budget) without mapping them, so
+ * that their layout and decorations are ready when switching to them. Only
+ * workspaces which changed since they were last pre-warmed are rendered
+ * again. Called by tree_render() before rendering the visible workspaces.
+ *
+ */
+void workspace_prewarm(void);
+
+/**
+ * Marks the workspace of the given container as changed, so that
+ * workspace_prewarm() renders it again. Called when containers are attached
+ * or detached.
+ *
+ */
+void workspace_prewarm_invalidate(Con *con);
+
 #if 0
 /**
  * Assigns the given workspace to the given screen by correctly updating its
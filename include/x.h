@@ -59,6 +59,13 @@ bool window_supports_protocol(xcb_window_t window, xcb_atom_t atom);
  */
 void x_window_kill(xcb_window_t window, kill_window_t kill_window);
 
+/**
+ * Kills the given X11 windows like x_window_kill(), but queries the
+ * WM_PROTOCOLS of all windows in a single round-trip and flushes only once.
+ *
+ */
+void x_window_kill_many(xcb_window_t *windows, int num, kill_window_t kill_window);
+
 /**
  * Draws the decoration of the given container onto its parent.
  *
@@ -0,0 +1,218 @@
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ */
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "libi3.h"
+
+/* Deeper nesting than this is considered malformed, so that a broken reply
+ * cannot exhaust the stack. */
+#define CBOR_MAX_DEPTH 256
+
+struct cbor_parser {
+    const unsigned char *pos;
+    const unsigned char *end;
+    const cbor_callbacks *callbacks;
+    void *ctx;
+    int depth;
+};
+
+/* Calls the given callback (if set) and cancels parsing if it returns 0 */
+#define CALL(parser, callback, ...)                                       \
+    do {                                                                  \
+        if ((parser)->callbacks->callback != NULL &&                      \
+            !(parser)->callbacks->callback((parser)->ctx, ##__VA_ARGS__)) \
+            return false;                                                 \
+    } while (0)
+
+/*
+ * Reads an unsigned integer of the given size in network byte order.
+ *
+ */
+static bool read_uint(struct cbor_parser *parser, int bytes, uint64_t *value) {
+    if (parser->end - parser->pos < bytes)
+        return false;
+    *value = 0;
+    for (int i = 0; i < bytes; i++)
+        *value = (*value << 8) | *(parser->pos++);
+    return true;
+}
+
+/*
+ * Converts an IEEE 754 half-precision float.
+ *
+ */
+static double half_to_double(uint16_t half) {
+    const int exponent = (half >> 10) & 0x1f;
+    const int mantissa = half & 0x3ff;
+    double value;
+    if (exponent == 0) {
+        value = mantissa / 16777216.0;
+    } else if (exponent == 31) {
+        value = (mantissa == 0 ? INFINITY : NAN);
+    } else {
+        value = mantissa + 1024;
+        for (int i = exponent - 25; i > 0; i--)
+            value *= 2;
+        for (int i = exponent - 25; i < 0; i++)
+            value /= 2;
+    }
+    return (half & 0x8000 ? -value : value);
+}
+
+/*
+ * Returns true (and skips it) if the next byte is the “break” which ends a map
+ * or an array of indefinite length.
+ *
+ */
+static bool at_break(struct cbor_parser *parser) {
+    if (parser->pos < parser->end && *(parser->pos) == 0xff) {
+        parser->pos++;
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Parses one data item (recursing into maps and arrays). Map keys have to be
+ * strings, they are passed to the map_key callback.
+ *
+ */
+static bool parse_item(struct cbor_parser *parser, bool is_key) {
+    if (parser->pos >= parser->end)
+        return false;
+
+    const unsigned char initial = *(parser->pos++);
+    const int major = initial >> 5;
+    const int info = initial & 0x1f;
+    const bool indefinite = (info == 31);
+    uint64_t argument = info;
+    if (info >= 24 && info <= 27) {
+        if (!read_uint(parser, 1 << (info - 24), &argument))
+            return false;
+    } else if (info >= 28 && info <= 30) {
+        return false;
+    }
+
+    /* Only strings, arrays and maps may have an indefinite length. */
+    if (indefinite && (major == 0 || major == 1 || major == 6))
+        return false;
+
+    if (is_key && major != 2 && major != 3)
+        return false;
+
+    switch (major) {
+        case 0:
+        case 1:
+            /* Integers which do not fit into a long long are not generated
+             * by i3 (and -1 - argument would overflow). */
+            if (argument > LLONG_MAX)
+                return false;
+            if (major == 0)
+                CALL(parser, cbor_integer, (long long)argument);
+            else
+                CALL(parser, cbor_integer, -1 - (long long)argument);
+            return true;
+        case 2:
+        case 3:
+            /* Strings of indefinite length are not generated by i3. */
+            if (indefinite || argument > (uint64_t)(parser->end - parser->pos))
+                return false;
+            if (is_key)
+                CALL(parser, cbor_map_key, parser->pos, argument);
+            else
+                CALL(parser, cbor_string, parser->pos, argument);
+            parser->pos += argument;
+            return true;
+        case 4:
+        case 5:
+            if (++(parser->depth) > CBOR_MAX_DEPTH)
+                return false;
+            if (major == 4)
+                CALL(parser, cbor_start_array);
+            else
+                CALL(parser, cbor_start_map);
+            for (uint64_t i = 0; indefinite ? !at_break(parser) : i < argument; i++) {
+                if (major == 5 && !parse_item(parser, true))
+                    return false;
+                if (!parse_item(parser, false))
+                    return false;
+            }
+            if (major == 4)
+                CALL(parser, cbor_end_array);
+            else
+                CALL(parser, cbor_end_map);
+            parser->depth--;
+            return true;
+        case 6: {
+            /* Tags only add semantics, the tagged item follows. Each tag
+             * counts towards the nesting depth, so that a long chain of tags
+             * cannot exhaust the stack. */
+            if (++(parser->depth) > CBOR_MAX_DEPTH)
+                return false;
+            const bool success = parse_item(parser, is_key);
+            parser->depth--;
+            return success;
+        }
+        case 7:
+            switch (info) {
+                case 20:
+                case 21:
+                    CALL(parser, cbor_boolean, info == 21);
+                    return true;
+                case 22:
+                case 23:
+                    CALL(parser, cbor_null);
+                    return true;
+                case 25:
+                    CALL(parser, cbor_double, half_to_double(argument));
+                    return true;
+                case 26: {
+                    uint32_t bits = argument;
+                    float value;
+                    memcpy(&value, &bits, sizeof(value));
+                    CALL(parser, cbor_double, value);
+                    return true;
+                }
+                case 27: {
+                    double value;
+                    memcpy(&value, &argument, sizeof(value));
+                    CALL(parser, cbor_double, value);
+                    return true;
+                }
+            }
+            return false;
+    }
+    return false;
+}
+
+/*
+ * Parses a CBOR-encoded reply (see I3_IPC_MESSAGE_FLAG_CBOR) and calls the
+ * given callbacks for each item, like yajl_parse() does for JSON.
+ *
+ * Returns false if the reply is malformed or a callback canceled parsing.
+ *
+ */
+bool cbor_parse(const unsigned char *data, size_t length,
+                const cbor_callbacks *callbacks, void *ctx) {
+    struct cbor_parser parser = {
+        .pos = data,
+        .end = data + length,
+        .callbacks = callbacks,
+        .ctx = ctx,
+        .depth = 0};
+
+    if (!parse_item(&parser, false))
+        return false;
+
+    /* A reply consists of exactly one item. */
+    return (parser.pos == parser.end);
+}
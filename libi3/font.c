@@ -10,6 +10,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <err.h>
 
 #if PANGO_SUPPORT
@@ -18,12 +19,43 @@
 #endif
 
 #include "libi3.h"
+#include "queue.h"
 
 extern xcb_connection_t *conn;
 extern xcb_screen_t *root_screen;
 
 static const i3Font *savedFont = NULL;
 
+/* Number of fonts which are kept open even though nobody uses them anymore,
+ * e.g. while reloading the config (the old font is freed before the new one
+ * is loaded). */
+#define FONT_CACHE_UNUSED_MAX 4
+
+/* Loaded fonts, keyed by the pattern passed to load_font() and the DPI, so
+ * that reloading the config does not need to open (and, for X core fonts,
+ * query) the same font again. The most recently used font comes first. */
+struct font_cache_entry {
+    char *pattern;
+    double dpi;
+
+    /* Number of load_font() results which were not freed yet. */
+    int refcount;
+
+    /* Set for X core fonts which were restored by font_cache_restore(): the
+     * metrics are known, but the font was not opened on this connection. */
+    bool needs_open;
+
+    /* The font itself. Its resources are owned by the cache. */
+    i3Font font;
+
+    TAILQ_ENTRY(font_cache_entry) entries;
+};
+
+static TAILQ_HEAD(font_cache_head, font_cache_entry) font_cache =
+    TAILQ_HEAD_INITIALIZER(font_cache);
+
+#define FONT_CACHE_MAGIC "i3-font-cache-1"
+
 #if PANGO_SUPPORT
 static xcb_visualtype_t *root_visual_type;
 static double pango_font_red;
@@ -171,24 +203,14 @@ static int predict_text_width_pango(const char *text, size_t text_len, bool is_m
 #endif
 
 /*
- * Loads a font for usage, also getting its metrics. If fallback is true,
- * the fonts 'fixed' or '-misc-*' will be loaded instead of exiting. If any
- * font was previously loaded, it will be freed.
+ * Opens the given font and gets its metrics. If fallback is true, the fonts
+ * 'fixed' or '-misc-*' will be loaded instead of exiting.
  *
  */
-i3Font load_font(const char *pattern, const bool fallback) {
-    /* if any font was previously loaded, free it now */
-    free_font();
-
+static i3Font open_font(const char *pattern, const bool fallback) {
     i3Font font;
     font.type = FONT_TYPE_NONE;
 
-    /* No XCB connction, return early because we're just validating the
-     * configuration file. */
-    if (conn == NULL) {
-        return font;
-    }
-
 #if PANGO_SUPPORT
     /* Try to load a pango font if specified */
     if (strlen(pattern) > strlen("pango:") && !strncmp(pattern, "pango:", strlen("pango:"))) {
@@ -264,6 +286,171 @@ i3Font load_font(const char *pattern, const bool fallback) {
     return font;
 }
 
+/*
+ * Frees the resources of the given font (but not its pattern).
+ *
+ */
+static void close_font(i3Font *font) {
+    switch (font->type) {
+        case FONT_TYPE_NONE:
+            /* Nothing to do */
+            break;
+        case FONT_TYPE_XCB: {
+            /* Close the font and free the info */
+            xcb_close_font(conn, font->specific.xcb.id);
+            if (font->specific.xcb.info)
+                free(font->specific.xcb.info);
+            break;
+        }
+#if PANGO_SUPPORT
+        case FONT_TYPE_PANGO:
+            /* Free the font description */
+            pango_font_description_free(font->specific.pango_desc);
+            break;
+#endif
+        default:
+            assert(false);
+            break;
+    }
+}
+
+/*
+ * Returns the DPI of the root window, which is part of the font cache key
+ * since the metrics of Pango fonts depend on it.
+ *
+ */
+static double font_cache_dpi(void) {
+    return (double)root_screen->height_in_pixels * 25.4 /
+           (double)root_screen->height_in_millimeters;
+}
+
+/*
+ * Returns the cache entry which holds the resources of the given font, or
+ * NULL if the font is not cached.
+ *
+ */
+static struct font_cache_entry *font_cache_entry_for(const i3Font *font) {
+    struct font_cache_entry *entry;
+    TAILQ_FOREACH(entry, &font_cache, entries) {
+        if (entry->font.type != font->type)
+            continue;
+        if (font->type == FONT_TYPE_XCB &&
+            entry->font.specific.xcb.id == font->specific.xcb.id)
+            return entry;
+#if PANGO_SUPPORT
+        if (font->type == FONT_TYPE_PANGO &&
+            entry->font.specific.pango_desc == font->specific.pango_desc)
+            return entry;
+#endif
+    }
+    return NULL;
+}
+
+/*
+ * Closes the least recently used fonts which are not used anymore, keeping
+ * at most FONT_CACHE_UNUSED_MAX of them.
+ *
+ */
+static void font_cache_evict(void) {
+    int unused = 0;
+    struct font_cache_entry *entry, *next;
+    for (entry = TAILQ_FIRST(&font_cache); entry != TAILQ_END(&font_cache); entry = next) {
+        next = TAILQ_NEXT(entry, entries);
+        if (entry->refcount > 0 || ++unused <= FONT_CACHE_UNUSED_MAX)
+            continue;
+
+        DLOG("Evicting font %s from the font cache\n", entry->pattern);
+        TAILQ_REMOVE(&font_cache, entry, entries);
+        if (!entry->needs_open)
+            close_font(&(entry->font));
+        else
+            free(entry->font.specific.xcb.info);
+        free(entry->font.pattern);
+        free(entry->pattern);
+        free(entry);
+    }
+}
+
+/*
+ * Loads a font for usage, also getting its metrics. If fallback is true,
+ * the fonts 'fixed' or '-misc-*' will be loaded instead of exiting. If any
+ * font was previously loaded, it will be freed.
+ *
+ * Fonts are cached for the lifetime of the process, so loading the same
+ * pattern again (e.g. when reloading the config) does not talk to the X
+ * server or Pango.
+ *
+ */
+i3Font load_font(const char *pattern, const bool fallback) {
+    /* if any font was previously loaded, free it now */
+    free_font();
+
+    i3Font font;
+    font.type = FONT_TYPE_NONE;
+
+    /* No XCB connction, return early because we're just validating the
+     * configuration file. */
+    if (conn == NULL) {
+        return font;
+    }
+
+    const double dpi = font_cache_dpi();
+    struct font_cache_entry *entry;
+    TAILQ_FOREACH(entry, &font_cache, entries) {
+        if (entry->dpi == dpi && strcmp(entry->pattern, pattern) == 0)
+            break;
+    }
+
+    if (entry != NULL) {
+        DLOG("Using cached font %s\n", entry->font.pattern);
+        TAILQ_REMOVE(&font_cache, entry, entries);
+    }
+
+    if (entry != NULL && entry->needs_open) {
+        /* The font was opened before the restart, but it might not be
+         * available anymore (e.g. because the font path changed). In that
+         * case, it is loaded like an uncached font, including the fallbacks. */
+        entry->font.specific.xcb.id = xcb_generate_id(conn);
+        xcb_void_cookie_t font_cookie = xcb_open_font_checked(conn, entry->font.specific.xcb.id,
+                                                              strlen(entry->font.pattern), entry->font.pattern);
+        xcb_generic_error_t *error = xcb_request_check(conn, font_cookie);
+        if (error == NULL) {
+            entry->needs_open = false;
+        } else {
+            ELOG("Could not open restored font %s (X error %d), loading it again.\n",
+                 entry->font.pattern, error->error_code);
+            free(error);
+            free(entry->font.specific.xcb.info);
+            free(entry->font.pattern);
+            free(entry->pattern);
+            free(entry);
+            entry = NULL;
+        }
+    }
+
+    if (entry == NULL) {
+        entry = scalloc(sizeof(struct font_cache_entry));
+        entry->pattern = sstrdup(pattern);
+        entry->dpi = dpi;
+        entry->font = open_font(pattern, fallback);
+    }
+
+#if PANGO_SUPPORT
+    /* Fonts restored by font_cache_restore() are used without calling
+     * load_pango_font(), which caches root_visual_type. */
+    if (entry->font.type == FONT_TYPE_PANGO && root_visual_type == NULL)
+        root_visual_type = get_visualtype(root_screen);
+#endif
+
+    TAILQ_INSERT_HEAD(&font_cache, entry, entries);
+    entry->refcount++;
+    font_cache_evict();
+
+    font = entry->font;
+    font.pattern = sstrdup(entry->font.pattern);
+    return font;
+}
+
 /*
  * Defines the font to be used for the forthcoming calls.
  *
@@ -282,30 +469,163 @@ void free_font(void) {
     if (savedFont == NULL)
         return;
 
+    /* The resources stay in the font cache, unless the cache is full */
+    struct font_cache_entry *entry = font_cache_entry_for(savedFont);
+    if (entry != NULL) {
+        entry->refcount--;
+        font_cache_evict();
+    } else {
+        close_font((i3Font *)savedFont);
+    }
+
     free(savedFont->pattern);
-    switch (savedFont->type) {
-        case FONT_TYPE_NONE:
-            /* Nothing to do */
+    savedFont = NULL;
+}
+
+/*
+ * Writes a length-prefixed buffer to the font cache file.
+ *
+ */
+static bool write_buffer(FILE *f, const void *buf, uint32_t len) {
+    return (fwrite(&len, sizeof(len), 1, f) == 1 &&
+            (len == 0 || fwrite(buf, len, 1, f) == 1));
+}
+
+/*
+ * Reads a length-prefixed buffer from the font cache file. The returned
+ * buffer is NUL-terminated and must be freed after use.
+ *
+ */
+static void *read_buffer(FILE *f, uint32_t *len) {
+    if (fread(len, sizeof(*len), 1, f) != 1)
+        return NULL;
+    char *buf = smalloc(*len + 1);
+    if (*len > 0 && fread(buf, *len, 1, f) != 1) {
+        free(buf);
+        return NULL;
+    }
+    buf[*len] = '\0';
+    return buf;
+}
+
+/*
+ * Saves the metrics of all cached fonts (the font heights and, for X core
+ * fonts, the QueryFont replies including the per-glyph tables) to the given
+ * file, so that they can be restored with font_cache_restore() after an
+ * in-place restart. Returns true on success.
+ *
+ */
+bool font_cache_save(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        ELOG("Could not open %s for saving the font cache\n", path);
+        return false;
+    }
+
+    bool success = (fwrite(FONT_CACHE_MAGIC, sizeof(FONT_CACHE_MAGIC), 1, f) == 1);
+    struct font_cache_entry *entry;
+    TAILQ_FOREACH(entry, &font_cache, entries) {
+        if (!success)
             break;
-        case FONT_TYPE_XCB: {
-            /* Close the font and free the info */
-            xcb_close_font(conn, savedFont->specific.xcb.id);
-            if (savedFont->specific.xcb.info)
-                free(savedFont->specific.xcb.info);
+
+        const uint32_t type = entry->font.type;
+        const int32_t height = entry->font.height;
+        if (type != FONT_TYPE_XCB && type != FONT_TYPE_PANGO)
+            continue;
+
+        success = (fwrite(&type, sizeof(type), 1, f) == 1 &&
+                   fwrite(&(entry->dpi), sizeof(entry->dpi), 1, f) == 1 &&
+                   fwrite(&height, sizeof(height), 1, f) == 1 &&
+                   write_buffer(f, entry->pattern, strlen(entry->pattern)) &&
+                   write_buffer(f, entry->font.pattern, strlen(entry->font.pattern)));
+
+        if (success && type == FONT_TYPE_XCB) {
+            /* A reply consists of 32 bytes plus length 4-byte units */
+            const xcb_query_font_reply_t *info = entry->font.specific.xcb.info;
+            success = write_buffer(f, info, 32 + info->length * 4);
+        }
+    }
+
+    if (fclose(f) != 0)
+        success = false;
+    if (!success)
+        ELOG("Could not save the font cache to %s\n", path);
+    return success;
+}
+
+/*
+ * Restores the fonts saved by font_cache_save(), so that loading them again
+ * neither needs to query the X server for their metrics nor to measure them
+ * with Pango. Returns true if the file could be read.
+ *
+ */
+bool font_cache_restore(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+        return false;
+
+    char magic[sizeof(FONT_CACHE_MAGIC)];
+    if (fread(magic, sizeof(magic), 1, f) != 1 ||
+        memcmp(magic, FONT_CACHE_MAGIC, sizeof(magic)) != 0) {
+        ELOG("%s is not a font cache, ignoring it\n", path);
+        fclose(f);
+        return false;
+    }
+
+    uint32_t type;
+    while (fread(&type, sizeof(type), 1, f) == 1) {
+        struct font_cache_entry *entry = scalloc(sizeof(struct font_cache_entry));
+        int32_t height;
+        uint32_t len;
+        if (fread(&(entry->dpi), sizeof(entry->dpi), 1, f) != 1 ||
+            fread(&height, sizeof(height), 1, f) != 1 ||
+            (entry->pattern = read_buffer(f, &len)) == NULL ||
+            (entry->font.pattern = read_buffer(f, &len)) == NULL) {
+            free(entry->pattern);
+            free(entry);
             break;
         }
+
+        entry->font.type = type;
+        entry->font.height = height;
+
+        if (type == FONT_TYPE_XCB) {
+            xcb_query_font_reply_t *info = read_buffer(f, &len);
+            if (info == NULL || len < 32 || len != 32 + info->length * 4) {
+                free(info);
+                free(entry->font.pattern);
+                free(entry->pattern);
+                free(entry);
+                break;
+            }
+            entry->font.specific.xcb.info = info;
+            if (xcb_query_font_char_infos_length(info) == 0)
+                entry->font.specific.xcb.table = NULL;
+            else
+                entry->font.specific.xcb.table = xcb_query_font_char_infos(info);
+            entry->needs_open = true;
+        }
 #if PANGO_SUPPORT
-        case FONT_TYPE_PANGO:
-            /* Free the font description */
-            pango_font_description_free(savedFont->specific.pango_desc);
-            break;
+        else if (type == FONT_TYPE_PANGO) {
+            /* The pattern is prefixed with pango: or xft: */
+            const char *desc = strchr(entry->font.pattern, ':');
+            entry->font.specific.pango_desc = pango_font_description_from_string(desc != NULL ? desc + 1 : entry->font.pattern);
+        }
 #endif
-        default:
-            assert(false);
-            break;
+        else {
+            free(entry->font.pattern);
+            free(entry->pattern);
+            free(entry);
+            continue;
+        }
+
+        DLOG("Restored font %s (height %d) from the font cache\n",
+             entry->font.pattern, entry->font.height);
+        TAILQ_INSERT_TAIL(&font_cache, entry, entries);
     }
 
-    savedFont = NULL;
+    fclose(f);
+    return true;
 }
 
 /*
@@ -35,14 +35,18 @@ state INITIAL:
   'focus_follows_mouse'                    -> FOCUS_FOLLOWS_MOUSE
   'mouse_warping'                          -> MOUSE_WARPING
   'force_focus_wrapping'                   -> FORCE_FOCUS_WRAPPING
+  'directional_focus'                      -> DIRECTIONAL_FOCUS
   'force_xinerama', 'force-xinerama'       -> FORCE_XINERAMA
   'workspace_auto_back_and_forth'          -> WORKSPACE_BACK_AND_FORTH
+  'workspace_prewarm'                      -> WORKSPACE_PREWARM
   'fake_outputs', 'fake-outputs'           -> FAKE_OUTPUTS
   'force_display_urgency_hint'             -> FORCE_DISPLAY_URGENCY_HINT
   'workspace'                              -> WORKSPACE
   'ipc_socket', 'ipc-socket'               -> IPC_SOCKET
   'restart_state'                          -> RESTART_STATE
   'popup_during_fullscreen'                -> POPUP_DURING_FULLSCREEN
+  'exec_concurrency'                       -> EXEC_CONCURRENCY
+  'fast_start'                             -> FAST_START
   exectype = 'exec_always', 'exec'         -> EXEC
   colorclass = 'client.background'
       -> COLOR_SINGLE
@@ -188,6 +192,11 @@ state FORCE_FOCUS_WRAPPING:
   value = word
       -> call cfg_force_focus_wrapping($value)
 
+# directional_focus tree|geometric
+state DIRECTIONAL_FOCUS:
+  value = 'tree', 'geometric'
+      -> call cfg_directional_focus($value)
+
 # force_xinerama
 state FORCE_XINERAMA:
   value = word
@@ -199,6 +208,17 @@ state WORKSPACE_BACK_AND_FORTH:
       -> call cfg_workspace_back_and_forth($value)
 
 
+# workspace_prewarm <budget> [mb]
+state WORKSPACE_PREWARM:
+  budget_mb = number
+      -> WORKSPACE_PREWARM_MB
+
+state WORKSPACE_PREWARM_MB:
+  'mb'
+      ->
+  end
+      -> call cfg_workspace_prewarm(&budget_mb)
+
 # fake_outputs (for testcases)
 state FAKE_OUTPUTS:
   outputs = string
@@ -267,12 +287,34 @@ state COLOR_INDICATOR:
   end
       -> call cfg_color($colorclass, $border, $background, $text, NULL)
 
-# <exec|exec_always> [--no-startup-id] command
+# exec_concurrency <limit>
+state EXEC_CONCURRENCY:
+  limit = number
+      -> call cfg_exec_concurrency(&limit)
+
+# fast_start <yes|no>
+state FAST_START:
+  value = word
+      -> call cfg_fast_start($value)
+
+# <exec|exec_always> [--no-startup-id] [--priority <priority>] [--wait-for-class <class>] command
 state EXEC:
   no_startup_id = '--no-startup-id'
       ->
+  '--priority'
+      -> EXEC_PRIORITY
+  '--wait-for-class'
+      -> EXEC_WAIT_FOR_CLASS
   command = string
-      -> call cfg_exec($exectype, $no_startup_id, $command)
+      -> call cfg_exec($exectype, $no_startup_id, &priority, $wait_for_class, $command)
+
+state EXEC_PRIORITY:
+  priority = number
+      -> EXEC
+
+state EXEC_WAIT_FOR_CLASS:
+  wait_for_class = word
+      -> EXEC
 
 # font font
 state FONT:
@@ -45,13 +45,14 @@ void run_assignments(i3Window *window) {
             DLOG("execute command %s\n", current->dest.command);
             char *full_command;
             sasprintf(&full_command, "[id=\"%d\"] %s", window->id, current->dest.command);
-            CommandResult *result = parse_command(full_command, NULL);
+            CommandResult result;
+            parse_command_noreply(full_command, &result);
             free(full_command);
 
-            if (result->needs_tree_render)
+            if (result.needs_tree_render)
                 needs_tree_render = true;
 
-            command_result_free(result);
+            free(result.error_message);
         }
 
         /* Store that we ran this assignment to not execute it again */
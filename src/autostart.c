@@ -0,0 +1,262 @@
+#undef I3__FILE__
+#define I3__FILE__ "autostart.c"
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * autostart.c: Starts the exec/exec_always lines of the config at startup,
+ *              ordered by priority and limited to exec_concurrency startups
+ *              in progress at the same time.
+ *
+ */
+#include "all.h"
+#include "encoder_utils.h"
+
+/* After this many seconds, commands waiting for a window of a specific class
+ * are started anyway, so that a missing application does not block them
+ * forever. */
+#define AUTOSTART_WAIT_TIMEOUT 30.0
+
+/* All autostarts which were queued by autostart_run(), sorted by descending
+ * priority (and in config order for equal priorities). */
+static TAILQ_HEAD(exec_queue_head, Autostart) exec_queue =
+    TAILQ_HEAD_INITIALIZER(exec_queue);
+
+/* Number of autostarts in state AS_RUNNING. */
+static int running;
+
+/* Set once AUTOSTART_WAIT_TIMEOUT elapsed. */
+static bool wait_timed_out;
+
+static struct ev_timer *wait_timer;
+
+/*
+ * Checks whether a window of the given class is currently managed.
+ *
+ */
+static bool class_is_managed(const char *class) {
+    Con *con;
+    TAILQ_FOREACH(con, &all_cons, all_cons) {
+        if (con->window != NULL &&
+            con->window->class_class != NULL &&
+            strcmp(con->window->class_class, class) == 0)
+            return true;
+    }
+    return false;
+}
+
+/*
+ * Starts queued autostarts (highest priority first) until the exec_concurrency
+ * limit is reached. Autostarts which are still waiting for a window of their
+ * class are skipped, but do not block the ones after them.
+ *
+ */
+static void exec_queue_dispatch(void) {
+    struct Autostart *exec;
+    TAILQ_FOREACH(exec, &exec_queue, exec_queue) {
+        if (config.exec_concurrency > 0 && running >= config.exec_concurrency)
+            break;
+
+        if (exec->state != AS_QUEUED)
+            continue;
+
+        if (exec->wait_for_class != NULL && !wait_timed_out &&
+            !class_is_managed(exec->wait_for_class)) {
+            DLOG("Not yet starting %s, waiting for a window of class %s\n",
+                 exec->command, exec->wait_for_class);
+            continue;
+        }
+
+        LOG("auto-starting %s\n", exec->command);
+        exec->started_at = ev_time();
+        struct Startup_Sequence *sequence = start_application(exec->command, exec->no_startup_id);
+        if (sequence == NULL) {
+            /* Without a startup notification, we cannot know when the
+             * application is done starting up, so it does not count against
+             * the limit. */
+            exec->state = AS_DONE;
+            continue;
+        }
+
+        sequence->autostart = exec;
+        exec->state = AS_RUNNING;
+        running++;
+    }
+}
+
+/*
+ * Marks the given autostart as done and starts the next queued ones.
+ *
+ */
+static void exec_done(struct Autostart *exec) {
+    if (exec->state != AS_RUNNING)
+        return;
+
+    exec->state = AS_DONE;
+    running--;
+    exec_queue_dispatch();
+}
+
+/*
+ * Starts all autostarts which are still waiting for a window of a specific
+ * class.
+ *
+ */
+static void wait_timeout(EV_P_ ev_timer *w, int revents) {
+    DLOG("Timeout waiting for windows, starting the remaining autostarts.\n");
+    wait_timed_out = true;
+    ev_timer_stop(main_loop, wait_timer);
+    FREE(wait_timer);
+    exec_queue_dispatch();
+}
+
+/*
+ * Inserts the given autostart into the exec queue, after all autostarts with
+ * the same or a higher priority.
+ *
+ */
+static void exec_queue_insert(struct Autostart *exec) {
+    exec->state = AS_QUEUED;
+    struct Autostart *current;
+    TAILQ_FOREACH(current, &exec_queue, exec_queue) {
+        if (current->priority >= exec->priority)
+            continue;
+        TAILQ_INSERT_BEFORE(current, exec, exec_queue);
+        return;
+    }
+    TAILQ_INSERT_TAIL(&exec_queue, exec, exec_queue);
+}
+
+/*
+ * Queues the exec (if run_exec is true) and exec_always lines of the config
+ * and starts as many of them as the exec_concurrency limit allows. The
+ * remaining ones are started whenever a running startup is completed.
+ *
+ */
+void autostart_run(bool run_exec) {
+    bool needs_wait_timer = false;
+    struct Autostart *exec;
+    if (run_exec) {
+        TAILQ_FOREACH(exec, &autostarts, autostarts) {
+            exec_queue_insert(exec);
+            needs_wait_timer |= (exec->wait_for_class != NULL);
+        }
+    }
+
+    TAILQ_FOREACH(exec, &autostarts_always, autostarts_always) {
+        exec_queue_insert(exec);
+        needs_wait_timer |= (exec->wait_for_class != NULL);
+    }
+
+    if (needs_wait_timer) {
+        wait_timer = scalloc(sizeof(struct ev_timer));
+        ev_timer_init(wait_timer, wait_timeout, AUTOSTART_WAIT_TIMEOUT, 0.);
+        ev_timer_start(main_loop, wait_timer);
+    }
+
+    exec_queue_dispatch();
+}
+
+/*
+ * Called when the startup sequence of an autostarted command was completed
+ * (or deleted), which allows the next queued command to be started.
+ *
+ */
+void autostart_sequence_completed(struct Startup_Sequence *sequence) {
+    if (sequence->autostart == NULL)
+        return;
+
+    DLOG("Startup of %s completed\n", sequence->autostart->command);
+    exec_done(sequence->autostart);
+}
+
+/*
+ * Called when the first window of the startup sequence of an autostarted
+ * command is managed. Records the launch-to-map latency and completes the
+ * startup of this command as far as the exec queue is concerned.
+ *
+ */
+void autostart_sequence_mapped(struct Startup_Sequence *sequence) {
+    struct Autostart *exec = sequence->autostart;
+    if (exec == NULL || exec->mapped_at > 0)
+        return;
+
+    exec->mapped_at = ev_time();
+    LOG("First window of %s managed after %.0f ms\n",
+        exec->command, (exec->mapped_at - exec->started_at) * 1000);
+    exec_done(exec);
+}
+
+/*
+ * Called for each newly managed window. Starts queued commands which were
+ * waiting for a window of this window’s class.
+ *
+ */
+void autostart_window_managed(i3Window *window) {
+    if (window->class_class == NULL)
+        return;
+
+    struct Autostart *exec;
+    TAILQ_FOREACH(exec, &exec_queue, exec_queue) {
+        if (exec->state != AS_QUEUED ||
+            exec->wait_for_class == NULL ||
+            strcmp(exec->wait_for_class, window->class_class) != 0)
+            continue;
+
+        DLOG("Window of class %s managed, %s can be started now\n",
+             window->class_class, exec->command);
+        exec_queue_dispatch();
+        return;
+    }
+}
+
+/*
+ * Dumps the exec queue (command, state and latencies of each autostarted
+ * command) as a JSON array, for the GET_STARTUP IPC reply.
+ *
+ */
+void autostart_dump(ipc_encoder *gen) {
+    y(array_open);
+    struct Autostart *exec;
+    TAILQ_FOREACH(exec, &exec_queue, exec_queue) {
+        y(map_open);
+
+        ystr("command");
+        ystr(exec->command);
+
+        ystr("priority");
+        y(integer, exec->priority);
+
+        ystr("wait_for_class");
+        if (exec->wait_for_class != NULL)
+            ystr(exec->wait_for_class);
+        else
+            y(null);
+
+        ystr("state");
+        switch (exec->state) {
+            case AS_QUEUED:
+                ystr("queued");
+                break;
+            case AS_RUNNING:
+                ystr("running");
+                break;
+            case AS_DONE:
+                ystr("done");
+                break;
+        }
+
+        /* Latencies are reported in milliseconds, relative to the time at
+         * which the command was started. */
+        ystr("map_latency");
+        if (exec->mapped_at > 0)
+            y(integer, (long long)((exec->mapped_at - exec->started_at) * 1000));
+        else
+            y(null);
+
+        y(map_close);
+    }
+    y(array_close);
+}
@@ -416,11 +416,10 @@ void binding_free(Binding *bind) {
 /*
  * Runs the given binding and handles parse errors. If con is passed, it will
  * execute the command binding with that container selected by criteria.
- * Returns a CommandResult for running the binding's command. Caller should
- * render tree if needs_tree_render is true. Free with command_result_free().
+ * Renders the tree if the command requires it.
  *
  */
-CommandResult *run_binding(Binding *bind, Con *con) {
+void run_binding(Binding *bind, Con *con) {
     char *command;
 
     /* We need to copy the binding and command since “reload” may be part of
@@ -432,13 +431,14 @@ CommandResult *run_binding(Binding *bind, Con *con) {
         sasprintf(&command, "[con_id=\"%d\"] %s", con, bind->command);
 
     Binding *bind_cp = binding_copy(bind);
-    CommandResult *result = parse_command(command, NULL);
+    CommandResult result;
+    parse_command_noreply(command, &result);
     free(command);
 
-    if (result->needs_tree_render)
+    if (result.needs_tree_render)
         tree_render();
 
-    if (result->parse_error) {
+    if (result.parse_error) {
         char *pageraction;
         sasprintf(&pageraction, "i3-sensible-pager \"%s\"\n", errorfilename);
         char *argv[] = {
@@ -457,8 +457,8 @@ CommandResult *run_binding(Binding *bind, Con *con) {
         free(pageraction);
     }
 
+    free(result.error_message);
+
     ipc_send_binding_event("run", bind_cp);
     binding_free(bind_cp);
-
-    return result;
 }
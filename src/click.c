@@ -188,17 +188,12 @@ static int route_click(Con *con, xcb_button_press_event_t *event, const bool mod
          * clicks on the inside of the window will only trigger a binding if
          * the --whole-window flag was given for the binding. */
         if (bind && (dest == CLICK_DECORATION || bind->whole_window)) {
-            CommandResult *result = run_binding(bind, con);
+            run_binding(bind, con);
 
             /* ASYNC_POINTER eats the event */
             xcb_allow_events(conn, XCB_ALLOW_ASYNC_POINTER, event->time);
             xcb_flush(conn);
 
-            if (result->needs_tree_render)
-                tree_render();
-
-            command_result_free(result);
-
             return 0;
         }
     }
@@ -389,14 +389,34 @@ void cmd_criteria_add(I3_CMD, char *ctype, char *cvalue) {
     ELOG("Unknown criterion: %s\n", ctype);
 }
 
+/*
+ * Moves the matched windows to the given workspace. When more than one window
+ * matches, the windows are moved as one batch, so that the focus is only
+ * updated once (see con_move_batch_begin()).
+ *
+ */
+static void move_matches_to_workspace(Con *ws) {
+    owindow *current;
+    const bool batch = (TAILQ_FIRST(&owindows) != TAILQ_LAST(&owindows, owindows_head));
+
+    if (batch)
+        con_move_batch_begin();
+
+    TAILQ_FOREACH(current, &owindows, owindows) {
+        DLOG("matching: %p / %s\n", current->con, current->con->name);
+        con_move_to_workspace(current->con, ws, true, false);
+    }
+
+    if (batch)
+        con_move_batch_end();
+}
+
 /*
  * Implementation of 'move [window|container] [to] workspace
  * next|prev|next_on_output|prev_on_output|current'.
  *
  */
 void cmd_move_con_to_workspace(I3_CMD, char *which) {
-    owindow *current;
-
     DLOG("which=%s\n", which);
 
     /* We have nothing to move:
@@ -429,10 +449,7 @@ void cmd_move_con_to_workspace(I3_CMD, char *which) {
         return;
     }
 
-    TAILQ_FOREACH(current, &owindows, owindows) {
-        DLOG("matching: %p / %s\n", current->con, current->con->name);
-        con_move_to_workspace(current->con, ws, true, false);
-    }
+    move_matches_to_workspace(ws);
 
     cmd_output->needs_tree_render = true;
     // XXX: default reply for now, make this a better reply
@@ -444,7 +461,6 @@ void cmd_move_con_to_workspace(I3_CMD, char *which) {
  *
  */
 void cmd_move_con_to_workspace_back_and_forth(I3_CMD) {
-    owindow *current;
     Con *ws;
 
     ws = workspace_back_and_forth_get();
@@ -456,10 +472,7 @@ void cmd_move_con_to_workspace_back_and_forth(I3_CMD) {
 
     HANDLE_EMPTY_MATCH;
 
-    TAILQ_FOREACH(current, &owindows, owindows) {
-        DLOG("matching: %p / %s\n", current->con, current->con->name);
-        con_move_to_workspace(current->con, ws, true, false);
-    }
+    move_matches_to_workspace(ws);
 
     cmd_output->needs_tree_render = true;
     // XXX: default reply for now, make this a better reply
@@ -477,8 +490,6 @@ void cmd_move_con_to_workspace_name(I3_CMD, char *name) {
         return;
     }
 
-    owindow *current;
-
     /* We have nothing to move:
      *  when criteria was specified but didn't match any window or
      *  when criteria wasn't specified and we don't have any window focused. */
@@ -500,10 +511,7 @@ void cmd_move_con_to_workspace_name(I3_CMD, char *name) {
 
     HANDLE_EMPTY_MATCH;
 
-    TAILQ_FOREACH(current, &owindows, owindows) {
-        DLOG("matching: %p / %s\n", current->con, current->con->name);
-        con_move_to_workspace(current->con, ws, true, false);
-    }
+    move_matches_to_workspace(ws);
 
     cmd_output->needs_tree_render = true;
     // XXX: default reply for now, make this a better reply
@@ -515,8 +523,6 @@ void cmd_move_con_to_workspace_name(I3_CMD, char *name) {
  *
  */
 void cmd_move_con_to_workspace_number(I3_CMD, char *which) {
-    owindow *current;
-
     /* We have nothing to move:
      *  when criteria was specified but didn't match any window or
      *  when criteria wasn't specified and we don't have any window focused. */
@@ -551,10 +557,7 @@ void cmd_move_con_to_workspace_number(I3_CMD, char *which) {
 
     HANDLE_EMPTY_MATCH;
 
-    TAILQ_FOREACH(current, &owindows, owindows) {
-        DLOG("matching: %p / %s\n", current->con, current->con->name);
-        con_move_to_workspace(current->con, workspace, true, false);
-    }
+    move_matches_to_workspace(workspace);
 
     cmd_output->needs_tree_render = true;
     // XXX: default reply for now, make this a better reply
@@ -1133,10 +1136,7 @@ void cmd_move_con_to_output(I3_CMD, char *name) {
         return;
     }
 
-    TAILQ_FOREACH(current, &owindows, owindows) {
-        DLOG("matching: %p / %s\n", current->con, current->con->name);
-        con_move_to_workspace(current->con, ws, true, false);
-    }
+    move_matches_to_workspace(ws);
 
     cmd_output->needs_tree_render = true;
     // XXX: default reply for now, make this a better reply
@@ -1246,11 +1246,21 @@ void cmd_kill(I3_CMD, char *kill_mode_str) {
     /* check if the match is empty, not if the result is empty */
     if (match_is_empty(current_match))
         tree_close_con(kill_mode);
-    else {
+    else if (!TAILQ_EMPTY(&owindows)) {
+        /* Kill all matching windows in one batch, see tree_close_many(). */
+        int num = 0;
+        TAILQ_FOREACH(current, &owindows, owindows)
+        num++;
+
+        Con **cons = smalloc(num * sizeof(Con *));
+        num = 0;
         TAILQ_FOREACH(current, &owindows, owindows) {
             DLOG("matching: %p / %s\n", current->con, current->con->name);
-            tree_close(current->con, kill_mode, false, false);
+            cons[num++] = current->con;
         }
+
+        tree_close_many(cons, num, kill_mode);
+        free(cons);
     }
 
     cmd_output->needs_tree_render = true;
@@ -1854,6 +1864,8 @@ void cmd_rename_workspace(I3_CMD, char *old_name, char *new_name) {
         return;
     }
 
+    workspace_history_rename(workspace->name, new_name);
+
     /* Change the name and try to parse it as a number. */
     FREE(workspace->name);
     workspace->name = sstrdup(new_name);
@@ -28,7 +28,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -56,11 +59,22 @@ typedef struct token {
     union {
         uint16_t call_identifier;
     } extra;
+    /* Determined by generate-command-parser.pl, so that we don’t need to
+     * compare token names while parsing. */
+    cmdp_token_kind kind;
+    /* For literals: the length of the literal and its first character in
+     * lowercase. */
+    int name_len;
+    int first;
 } cmdp_token;
 
 typedef struct tokenptr {
     cmdp_token *array;
     int n;
+    /* For states with many literals: the index of the first token which can
+     * match input starting with the given (lowercase, ASCII) character. NULL
+     * for all other states. */
+    const uint8_t *dispatch;
 } cmdp_token_ptr;
 
 #include "GENERATED_command_tokens.h"
@@ -74,6 +88,8 @@ struct stack_entry {
     /* Just a pointer, not dynamically allocated. */
     const char *identifier;
     char *str;
+    /* Literals are not copied, so str points into the token table. */
+    bool literal;
 };
 
 /* 10 entries should be enough for everybody. */
@@ -82,15 +98,17 @@ static struct stack_entry stack[10];
 /*
  * Pushes a string (identified by 'identifier') on the stack. We simply use a
  * single array, since the number of entries we have to store is very small.
+ * The string is freed by clear_stack(), unless it is a literal.
  *
  */
-static void push_string(const char *identifier, char *str) {
+static void push_string(const char *identifier, char *str, bool literal) {
     for (int c = 0; c < 10; c++) {
         if (stack[c].identifier != NULL)
             continue;
         /* Found a free slot, let’s store it here. */
         stack[c].identifier = identifier;
         stack[c].str = str;
+        stack[c].literal = literal;
         return;
     }
 
@@ -117,7 +135,7 @@ static char *get_string(const char *identifier) {
 
 static void clear_stack(void) {
     for (int c = 0; c < 10; c++) {
-        if (stack[c].str != NULL)
+        if (stack[c].str != NULL && !stack[c].literal)
             free(stack[c].str);
         stack[c].identifier = NULL;
         stack[c].str = NULL;
@@ -261,16 +279,14 @@ char *parse_string(const char **walk, bool as_word) {
 }
 
 /*
- * Parses and executes the given command. If a caller-allocated yajl_gen is
- * passed, a json reply will be generated in the format specified by the ipc
- * protocol. Pass NULL if no json reply is required.
+ * Parses and executes the given command, storing the outcome in 'result'
+ * (which has to be zeroed). A json reply is generated only if gen is not
+ * NULL.
  *
- * Free the returned CommandResult with command_result_free().
  */
-CommandResult *parse_command(const char *input, yajl_gen gen) {
+static void _parse_command(const char *input, yajl_gen gen, CommandResult *result) {
     DLOG("COMMAND: *%s*\n", input);
     state = INITIAL;
-    CommandResult *result = scalloc(sizeof(CommandResult));
 
     /* A YAJL JSON generator used for formatting replies. */
     command_output.json_gen = gen;
@@ -300,15 +316,18 @@ CommandResult *parse_command(const char *input, yajl_gen gen) {
 
         cmdp_token_ptr *ptr = &(tokens[state]);
         token_handled = false;
-        for (c = 0; c < ptr->n; c++) {
+        const int first = tolower((unsigned char)*walk);
+        c = (ptr->dispatch != NULL ? ptr->dispatch[first < 128 ? first : 0] : 0);
+        for (; c < ptr->n; c++) {
             token = &(ptr->array[c]);
 
             /* A literal. */
-            if (token->name[0] == '\'') {
-                if (strncasecmp(walk, token->name + 1, strlen(token->name) - 1) == 0) {
+            if (token->kind == TK_LITERAL) {
+                if (token->first == first &&
+                    strncasecmp(walk, token->name + 1, token->name_len) == 0) {
                     if (token->identifier != NULL)
-                        push_string(token->identifier, sstrdup(token->name + 1));
-                    walk += strlen(token->name) - 1;
+                        push_string(token->identifier, token->name + 1, true);
+                    walk += token->name_len;
                     next_state(token);
                     token_handled = true;
                     break;
@@ -316,12 +335,13 @@ CommandResult *parse_command(const char *input, yajl_gen gen) {
                 continue;
             }
 
-            if (strcmp(token->name, "string") == 0 ||
-                strcmp(token->name, "word") == 0) {
-                char *str = parse_string(&walk, (token->name[0] != 's'));
+            if (token->kind == TK_STRING || token->kind == TK_WORD) {
+                char *str = parse_string(&walk, (token->kind == TK_WORD));
                 if (str != NULL) {
                     if (token->identifier)
-                        push_string(token->identifier, str);
+                        push_string(token->identifier, str, false);
+                    else
+                        free(str);
                     /* If we are at the end of a quoted string, skip the ending
                      * double quote. */
                     if (*walk == '"')
@@ -332,7 +352,7 @@ CommandResult *parse_command(const char *input, yajl_gen gen) {
                 }
             }
 
-            if (strcmp(token->name, "end") == 0) {
+            if (token->kind == TK_END) {
                 if (*walk == '\0' || *walk == ',' || *walk == ';') {
                     next_state(token);
                     token_handled = true;
@@ -431,9 +451,35 @@ CommandResult *parse_command(const char *input, yajl_gen gen) {
     y(array_close);
 
     result->needs_tree_render = command_output.needs_tree_render;
+}
+
+/*
+ * Parses and executes the given command. If a caller-allocated yajl_gen is
+ * passed, a json reply will be generated in the format specified by the ipc
+ * protocol. Pass NULL if no json reply is required.
+ *
+ * Free the returned CommandResult with command_result_free().
+ */
+CommandResult *parse_command(const char *input, yajl_gen gen) {
+    CommandResult *result = scalloc(sizeof(CommandResult));
+    _parse_command(input, gen, result);
     return result;
 }
 
+/*
+ * Parses and executes the given command without generating a json reply and
+ * without allocating a CommandResult. Meant for commands which i3 runs itself
+ * (key bindings, for_window and assignments), where nobody reads the reply.
+ *
+ * The outcome is stored in the caller-provided 'result'. Only
+ * result->error_message (set for parse errors) needs to be freed.
+ *
+ */
+void parse_command_noreply(const char *input, CommandResult *result) {
+    memset(result, 0, sizeof(CommandResult));
+    _parse_command(input, NULL, result);
+}
+
 /*
  * Frees a CommandResult
  */
@@ -475,11 +521,174 @@ void errorlog(char *fmt, ...) {
     va_end(args);
 }
 
+static long allocations;
+
+#ifdef COUNT_ALLOCATIONS
+/* If the linker supports it, test.commands_parser is linked with -Wl,--wrap
+ * for these functions (see src/i3.mk), so that the benchmark can count the
+ * allocations made by the parser and libi3. */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+char *__real_strdup(const char *str);
+
+void *__wrap_malloc(size_t size) {
+    allocations++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size) {
+    allocations++;
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    allocations++;
+    return __real_realloc(ptr, size);
+}
+
+char *__wrap_strdup(const char *str) {
+    allocations++;
+    return __real_strdup(str);
+}
+#endif
+
+/* yajl is a shared library, so its allocations are routed through the
+ * (counting) wrappers by passing these functions to yajl_gen_alloc(). */
+static void *bench_yajl_malloc(void *ctx, size_t size) {
+    return malloc(size);
+}
+
+static void *bench_yajl_realloc(void *ctx, void *ptr, size_t size) {
+    return realloc(ptr, size);
+}
+
+static void bench_yajl_free(void *ctx, void *ptr) {
+    free(ptr);
+}
+
+static yajl_alloc_funcs bench_yajl_funcs = {
+    bench_yajl_malloc,
+    bench_yajl_realloc,
+    bench_yajl_free,
+    NULL};
+
+/*
+ * Parses all commands 'rounds' times, either like IPC commands (with a json
+ * reply) or like key bindings (using parse_command_noreply()). Returns the
+ * elapsed time, the number of allocations is left in 'allocations'.
+ *
+ */
+static ev_tstamp benchmark_mode(char **commands, int num_commands, int rounds, bool reply) {
+    allocations = 0;
+    const ev_tstamp start = ev_time();
+    for (int round = 0; round < rounds; round++) {
+        for (int c = 0; c < num_commands; c++) {
+            if (reply) {
+                yajl_gen gen = yajl_gen_alloc(&bench_yajl_funcs);
+                command_result_free(parse_command(commands[c], gen));
+                yajl_gen_free(gen);
+            } else {
+                CommandResult result;
+                parse_command_noreply(commands[c], &result);
+                free(result.error_message);
+            }
+        }
+    }
+    return ev_time() - start;
+}
+
+/*
+ * Prints the throughput of one mode of the benchmark and, if they were
+ * counted, the allocations per command.
+ *
+ */
+static void print_result(const char *mode, ev_tstamp elapsed, long num_allocations, long total) {
+    printf("%-8s %.3f s, %.0f commands/s", mode, elapsed, total / elapsed);
+#ifdef COUNT_ALLOCATIONS
+    printf(", %.1f allocations/command\n", (double)num_allocations / total);
+#else
+    printf(" (allocations not counted)\n");
+#endif
+}
+
+/*
+ * Parses each line of the given corpus file (empty lines and lines starting
+ * with # are skipped) 'rounds' times in both modes and prints the throughput
+ * and the number of allocations per command. The debug output of the parser
+ * is discarded while measuring.
+ *
+ */
+static int benchmark(const char *corpus, int rounds) {
+    FILE *file = fopen(corpus, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Could not open %s: %s\n", corpus, strerror(errno));
+        return 1;
+    }
+
+    char **commands = NULL;
+    int num_commands = 0;
+    char *line = NULL;
+    size_t line_size = 0;
+    ssize_t read;
+    while ((read = getline(&line, &line_size, file)) != -1) {
+        if (read > 0 && line[read - 1] == '\n')
+            line[--read] = '\0';
+        if (read == 0 || line[0] == '#')
+            continue;
+        commands = srealloc(commands, (num_commands + 1) * sizeof(char *));
+        commands[num_commands++] = sstrdup(line);
+    }
+    free(line);
+    fclose(file);
+
+    fflush(stdout);
+    fflush(stderr);
+    const int saved_stdout = dup(STDOUT_FILENO);
+    const int saved_stderr = dup(STDERR_FILENO);
+    const int devnull = open("/dev/null", O_WRONLY);
+    dup2(devnull, STDOUT_FILENO);
+    dup2(devnull, STDERR_FILENO);
+
+    const ev_tstamp reply_elapsed = benchmark_mode(commands, num_commands, rounds, true);
+    const long reply_allocations = allocations;
+    const ev_tstamp noreply_elapsed = benchmark_mode(commands, num_commands, rounds, false);
+    const long noreply_allocations = allocations;
+
+    fflush(stdout);
+    fflush(stderr);
+    dup2(saved_stdout, STDOUT_FILENO);
+    dup2(saved_stderr, STDERR_FILENO);
+    close(saved_stdout);
+    close(saved_stderr);
+    close(devnull);
+
+    const long total = (long)num_commands * rounds;
+    printf("%ld commands (%d distinct) per mode\n", total, num_commands);
+    print_result("reply:", reply_elapsed, reply_allocations, total);
+    print_result("noreply:", noreply_elapsed, noreply_allocations, total);
+
+    for (int c = 0; c < num_commands; c++)
+        free(commands[c]);
+    free(commands);
+    return 0;
+}
+
 int main(int argc, char *argv[]) {
     if (argc < 2) {
         fprintf(stderr, "Syntax: %s <command>\n", argv[0]);
+        fprintf(stderr, "        %s --bench <corpus> [<rounds>]\n", argv[0]);
         return 1;
     }
+
+    if (strcmp(argv[1], "--bench") == 0) {
+        if (argc < 3) {
+            fprintf(stderr, "Syntax: %s --bench <corpus> [<rounds>]\n", argv[0]);
+            return 1;
+        }
+        return benchmark(argv[2], (argc > 3 ? atoi(argv[3]) : 1000));
+    }
+
     yajl_gen gen = yajl_gen_alloc(NULL);
 
     CommandResult *result = parse_command(argv[1], gen);
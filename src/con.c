@@ -12,10 +12,19 @@
  *
  */
 #include "all.h"
-#include "yajl_utils.h"
 
 static void con_on_remove_child(Con *con);
 
+/* State of the current batch of moves, see con_move_batch_begin(). */
+static struct {
+    bool active;
+    /* The workspace which was focused when the batch began. */
+    Con *workspace;
+    /* The moved containers, whose "move" events are sent at the end. */
+    Con **moved;
+    int num_moved;
+} move_batch;
+
 /*
  * force parent split containers to be redrawn
  *
@@ -119,6 +128,7 @@ void con_attach(Con *con, Con *parent, bool ignore_focus) {
     if (con->type == CT_FLOATING_CON) {
         DLOG("Inserting into floating containers\n");
         TAILQ_INSERT_TAIL(&(parent->floating_head), con, floating_windows);
+        scratchpad_update(con, false);
     } else {
         if (!ignore_focus) {
             /* Get the first tiling container in focus stack */
@@ -168,6 +178,10 @@ add_to_focus_head:
      * to focus them. */
     TAILQ_INSERT_TAIL(focus_head, con, focused);
     con_force_split_parents_redraw(con);
+    focus_index_invalidate(con);
+    workspace_prewarm_invalidate(con);
+    /* The container might have been moved to another workspace. */
+    ewmh_update_window_hints(con);
 }
 
 /*
@@ -176,6 +190,8 @@ add_to_focus_head:
  */
 void con_detach(Con *con) {
     con_force_split_parents_redraw(con);
+    focus_index_invalidate(con);
+    workspace_prewarm_invalidate(con);
     if (con->type == CT_FLOATING_CON) {
         TAILQ_REMOVE(&(con->parent->floating_head), con, floating_windows);
         TAILQ_REMOVE(&(con->parent->focus_head), con, focused);
@@ -594,19 +610,7 @@ static void con_set_fullscreen_mode(Con *con, fullscreen_mode_t fullscreen_mode)
     ipc_send_window_event("fullscreen_mode", con);
 
     /* update _NET_WM_STATE if this container has a window */
-    /* TODO: when a window is assigned to a container which is already
-     * fullscreened, this state needs to be pushed to the client, too */
-    if (con->window == NULL)
-        return;
-
-    uint32_t values[1];
-    unsigned int num = 0;
-
-    if (con->fullscreen_mode != CF_NONE)
-        values[num++] = A__NET_WM_STATE_FULLSCREEN;
-
-    xcb_change_property(conn, XCB_PROP_MODE_REPLACE, con->window->id,
-                        A__NET_WM_STATE, XCB_ATOM_ATOM, 32, num, values);
+    ewmh_update_window_hints(con);
 }
 
 /*
@@ -682,6 +686,69 @@ void con_disable_fullscreen(Con *con) {
     con_set_fullscreen_mode(con, CF_NONE);
 }
 
+/*
+ * Deletes the startup sequences associated with the window of the given
+ * container or with the windows of its direct children. The _NET_STARTUP_ID
+ * requests for all windows are sent before waiting for any reply, then those
+ * for the leaders of the windows which have none of their own.
+ *
+ */
+static void con_delete_startup_sequences(Con *con) {
+    int num_windows = (con->window ? 1 : 0);
+    Con *child;
+    if (!con_is_leaf(con)) {
+        TAILQ_FOREACH(child, &(con->nodes_head), nodes) {
+            if (child->window)
+                num_windows++;
+        }
+    }
+    if (num_windows == 0)
+        return;
+
+    i3Window **windows = smalloc(num_windows * sizeof(i3Window *));
+    xcb_get_property_cookie_t *cookies = smalloc(num_windows * sizeof(xcb_get_property_cookie_t));
+    xcb_get_property_reply_t **replies = smalloc(num_windows * sizeof(xcb_get_property_reply_t *));
+    xcb_get_property_cookie_t *leader_cookies = smalloc(num_windows * sizeof(xcb_get_property_cookie_t));
+    int n = 0;
+    if (!con_is_leaf(con)) {
+        TAILQ_FOREACH(child, &(con->nodes_head), nodes) {
+            if (child->window)
+                windows[n++] = child->window;
+        }
+    }
+    if (con->window)
+        windows[n++] = con->window;
+
+    for (int i = 0; i < num_windows; i++)
+        cookies[i] = xcb_get_property(conn, false, windows[i]->id,
+                                      A__NET_STARTUP_ID, XCB_GET_PROPERTY_TYPE_ANY, 0, 512);
+
+    /* Only windows without a _NET_STARTUP_ID need the one of their leader
+     * (and only if the leader is not mapped, see startup_sequence_get()). */
+    for (int i = 0; i < num_windows; i++) {
+        replies[i] = xcb_get_property_reply(conn, cookies[i], NULL);
+        if (windows[i]->leader != XCB_NONE && con_by_window_id(windows[i]->leader) == NULL)
+            leader_cookies[i] = startup_leader_startup_id(windows[i], replies[i]);
+        else
+            leader_cookies[i].sequence = 0;
+    }
+
+    for (int i = 0; i < num_windows; i++) {
+        xcb_get_property_reply_t *leader_startup_id_reply = NULL;
+        if (leader_cookies[i].sequence != 0)
+            leader_startup_id_reply = xcb_get_property_reply(conn, leader_cookies[i], NULL);
+
+        struct Startup_Sequence *sequence = startup_sequence_get(windows[i], replies[i], leader_startup_id_reply, true);
+        if (sequence != NULL)
+            startup_sequence_delete(sequence);
+    }
+
+    free(windows);
+    free(cookies);
+    free(replies);
+    free(leader_cookies);
+}
+
 /*
  * Moves the given container to the currently focused container on the given
  * workspace.
@@ -738,7 +805,8 @@ void con_move_to_workspace(Con *con, Con *workspace, bool fix_coordinates, bool
 
     /* Save the current workspace. So we can call workspace_show() by the end
      * of this function. */
-    Con *current_ws = con_get_workspace(focused);
+    Con *current_ws = (move_batch.active ? move_batch.workspace : con_get_workspace(focused));
+    Con *old_focused = focused;
 
     Con *source_output = con_get_output(con),
         *dest_output = con_get_output(workspace);
@@ -781,8 +849,9 @@ void con_move_to_workspace(Con *con, Con *workspace, bool fix_coordinates, bool
 
         /* If moving to a visible workspace, call show so it can be considered
          * focused. Must do before attaching because workspace_show checks to see
-         * if focused container is in its area. */
-        if (workspace_is_visible(workspace)) {
+         * if focused container is in its area. Within a batch, focus stays on
+         * the current workspace, so this is skipped. */
+        if (!move_batch.active && workspace_is_visible(workspace)) {
             workspace_show(workspace);
 
             /* Don’t warp if told so (when dragging floating windows with the
@@ -833,6 +902,23 @@ void con_move_to_workspace(Con *con, Con *workspace, bool fix_coordinates, bool
     /* 8: when moving to another workspace, we leave the focus on the current
      * workspace. (see also #809) */
 
+    if (move_batch.active) {
+        /* Within a batch, focus is put back onto the current workspace right
+         * away, without switching workspaces (and sending the corresponding
+         * events) for every single container. */
+        if (source_ws == current_ws)
+            con_focus(con_descend_focused(focus_next));
+        else if (con_get_workspace(focused) != current_ws || focused->type == CT_WORKSPACE)
+            con_focus(old_focused);
+
+        con_delete_startup_sequences(con);
+        CALL(parent, on_remove_child);
+
+        move_batch.moved = srealloc(move_batch.moved, (move_batch.num_moved + 1) * sizeof(Con *));
+        move_batch.moved[move_batch.num_moved++] = con;
+        return;
+    }
+
     /* Descend focus stack in case focus_next is a workspace which can
      * occur if we move to the same workspace.  Also show current workspace
      * to ensure it is focused. */
@@ -845,39 +931,50 @@ void con_move_to_workspace(Con *con, Con *workspace, bool fix_coordinates, bool
 
     /* If anything within the container is associated with a startup sequence,
      * delete it so child windows won't be created on the old workspace. */
-    struct Startup_Sequence *sequence;
-    xcb_get_property_cookie_t cookie;
-    xcb_get_property_reply_t *startup_id_reply;
+    con_delete_startup_sequences(con);
 
-    if (!con_is_leaf(con)) {
-        Con *child;
-        TAILQ_FOREACH(child, &(con->nodes_head), nodes) {
-            if (!child->window)
-                continue;
+    CALL(parent, on_remove_child);
 
-            cookie = xcb_get_property(conn, false, child->window->id,
-                                      A__NET_STARTUP_ID, XCB_GET_PROPERTY_TYPE_ANY, 0, 512);
-            startup_id_reply = xcb_get_property_reply(conn, cookie, NULL);
+    ipc_send_window_event("move", con);
+}
 
-            sequence = startup_sequence_get(child->window, startup_id_reply, true);
-            if (sequence != NULL)
-                startup_sequence_delete(sequence);
-        }
-    }
+/*
+ * Begins a batch of moves: until con_move_batch_end() is called,
+ * con_move_to_workspace() keeps the focus on the currently focused workspace
+ * instead of switching workspaces for each moved container, and the "move"
+ * window events are deferred.
+ *
+ * Used by commands which move all windows matching the criteria, so that
+ * moving many windows only updates the focus (and sends the workspace events)
+ * once.
+ *
+ */
+void con_move_batch_begin(void) {
+    assert(!move_batch.active);
+    move_batch.active = true;
+    move_batch.workspace = con_get_workspace(focused);
+}
 
-    if (con->window) {
-        cookie = xcb_get_property(conn, false, con->window->id,
-                                  A__NET_STARTUP_ID, XCB_GET_PROPERTY_TYPE_ANY, 0, 512);
-        startup_id_reply = xcb_get_property_reply(conn, cookie, NULL);
+/*
+ * Ends a batch of moves (see con_move_batch_begin()): focuses the workspace
+ * which was focused when the batch began and sends the "move" window events
+ * for all moved containers.
+ *
+ */
+void con_move_batch_end(void) {
+    assert(move_batch.active);
+    move_batch.active = false;
 
-        sequence = startup_sequence_get(con->window, startup_id_reply, true);
-        if (sequence != NULL)
-            startup_sequence_delete(sequence);
-    }
+    DLOG("Moved %d containers in one batch\n", move_batch.num_moved);
+    if (move_batch.num_moved > 0)
+        workspace_show(move_batch.workspace);
 
-    CALL(parent, on_remove_child);
+    for (int i = 0; i < move_batch.num_moved; i++)
+        ipc_send_window_event("move", move_batch.moved[i]);
 
-    ipc_send_window_event("move", con);
+    FREE(move_batch.moved);
+    move_batch.num_moved = 0;
+    move_batch.workspace = NULL;
 }
 
 /*
@@ -1226,6 +1323,45 @@ int con_border_style(Con *con) {
     return con->border_style;
 }
 
+/*
+ * Sets the sticky group of the given container (NULL removes it from its
+ * group) and keeps the registry of sticky groups up to date.
+ *
+ */
+void con_set_sticky_group(Con *con, const char *sticky_group) {
+    struct Sticky_Group *group = con->sticky;
+    if (group != NULL) {
+        TAILQ_REMOVE(&(group->cons_head), con, sticky_cons);
+        if (TAILQ_EMPTY(&(group->cons_head))) {
+            DLOG("Sticky group %s is empty now\n", group->name);
+            TAILQ_REMOVE(&sticky_groups, group, sticky_groups);
+            free(group->name);
+            free(group);
+        }
+        con->sticky = NULL;
+    }
+    FREE(con->sticky_group);
+
+    if (sticky_group == NULL)
+        return;
+
+    con->sticky_group = sstrdup(sticky_group);
+    TAILQ_FOREACH(group, &sticky_groups, sticky_groups) {
+        if (strcmp(group->name, sticky_group) == 0)
+            break;
+    }
+
+    if (group == NULL) {
+        group = scalloc(sizeof(struct Sticky_Group));
+        group->name = sstrdup(sticky_group);
+        TAILQ_INIT(&(group->cons_head));
+        TAILQ_INSERT_TAIL(&sticky_groups, group, sticky_groups);
+    }
+
+    TAILQ_INSERT_TAIL(&(group->cons_head), con, sticky_cons);
+    con->sticky = group;
+}
+
 /*
  * Sets the given border style on con, correctly keeping the position/size of a
  * floating window.
@@ -1283,6 +1419,8 @@ void con_set_layout(Con *con, layout_t layout) {
     if (con->type != CT_WORKSPACE)
         con = con->parent;
 
+    focus_index_invalidate(con);
+
     /* We fill in last_split_layout when switching to a different layout
      * since there are many places in the code that don’t use
      * con_set_layout(). */
@@ -1436,15 +1574,20 @@ static void con_on_remove_child(Con *con) {
     if (con->type == CT_WORKSPACE) {
         if (TAILQ_EMPTY(&(con->focus_head)) && !workspace_is_visible(con)) {
             LOG("Closing old workspace (%p / %s), it is empty\n", con, con->name);
-            yajl_gen gen = ipc_marshal_workspace_event("empty", con, NULL);
+            /* The workspace is freed below, so the event has to be serialized
+             * now, but only in the flavors somebody is subscribed to. */
+            ipc_encoder *gen = NULL, *compact_gen = NULL;
+            if (ipc_has_event_subscribers("workspace", false))
+                gen = ipc_marshal_workspace_event("empty", con, NULL, false);
+            if (ipc_has_event_subscribers("workspace", true))
+                compact_gen = ipc_marshal_workspace_event("empty", con, NULL, true);
             tree_close(con, DONT_KILL_WINDOW, false, false);
 
-            const unsigned char *payload;
-            ylength length;
-            y(get_buf, &payload, &length);
-            ipc_send_event("workspace", I3_IPC_EVENT_WORKSPACE, (const char *)payload);
-
-            y(free);
+            ipc_send_marshalled_event("workspace", I3_IPC_EVENT_WORKSPACE, gen, compact_gen);
+            ewmh_update_current_desktop();
+            ewmh_update_number_of_desktops();
+            ewmh_update_desktop_names();
+            ewmh_update_desktop_viewport();
         }
         return;
     }
@@ -1613,6 +1756,9 @@ bool con_has_urgent_child(Con *con) {
 void con_update_parents_urgency(Con *con) {
     Con *parent = con->parent;
 
+    /* The urgency of the window is reflected in its _NET_WM_STATE. */
+    ewmh_update_window_hints(con);
+
     bool new_urgency_value = con->urgent;
     while (parent && parent->type != CT_WORKSPACE && parent->type != CT_DOCKAREA) {
         if (new_urgency_value) {
@@ -273,8 +273,10 @@ void load_configuration(xcb_connection_t *conn, const char *override_configpath,
 
     if (config.font.type == FONT_TYPE_NONE) {
         ELOG("You did not specify required configuration option \"font\"\n");
+        timeline_begin("font");
         config.font = load_font("fixed", true);
         set_font(&config.font);
+        timeline_end("font");
     }
 
     /* Redraw the currently visible decorations on reload, so that
@@ -163,8 +163,10 @@ uint32_t modifiers_from_str(const char *str) {
 static char *font_pattern;
 
 CFGFUN(font, const char *font) {
+    timeline_begin("font");
     config.font = load_font(font, true);
     set_font(&config.font);
+    timeline_end("font");
 
     /* Save the font pattern for using it as bar font later on */
     FREE(font_pattern);
@@ -195,10 +197,13 @@ CFGFUN(enter_mode, const char *modename) {
     current_mode = sstrdup(modename);
 }
 
-CFGFUN(exec, const char *exectype, const char *no_startup_id, const char *command) {
-    struct Autostart *new = smalloc(sizeof(struct Autostart));
+CFGFUN(exec, const char *exectype, const char *no_startup_id, const long priority, const char *wait_for_class, const char *command) {
+    struct Autostart *new = scalloc(sizeof(struct Autostart));
     new->command = sstrdup(command);
     new->no_startup_id = (no_startup_id != NULL);
+    new->priority = priority;
+    if (wait_for_class != NULL)
+        new->wait_for_class = sstrdup(wait_for_class);
     if (strcmp(exectype, "exec") == 0) {
         TAILQ_INSERT_TAIL(&autostarts, new, autostarts);
     } else {
@@ -206,6 +211,18 @@ CFGFUN(exec, const char *exectype, const char *no_startup_id, const char *comman
     }
 }
 
+CFGFUN(exec_concurrency, const long limit) {
+    if (limit < 0) {
+        ELOG("exec_concurrency must not be negative, ignoring\n");
+        return;
+    }
+    config.exec_concurrency = limit;
+}
+
+CFGFUN(fast_start, const char *value) {
+    config.fast_start = eval_boolstr(value);
+}
+
 CFGFUN(for_window, const char *command) {
     if (match_is_empty(current_match)) {
         ELOG("Match is empty, ignoring this for_window statement\n");
@@ -321,10 +338,25 @@ CFGFUN(force_focus_wrapping, const char *value) {
     config.force_focus_wrapping = eval_boolstr(value);
 }
 
+CFGFUN(directional_focus, const char *value) {
+    if (strcmp(value, "geometric") == 0)
+        config.directional_focus = DIRECTIONAL_FOCUS_GEOMETRIC;
+    else
+        config.directional_focus = DIRECTIONAL_FOCUS_TREE;
+}
+
 CFGFUN(workspace_back_and_forth, const char *value) {
     config.workspace_auto_back_and_forth = eval_boolstr(value);
 }
 
+CFGFUN(workspace_prewarm, const long budget_mb) {
+    if (budget_mb < 0) {
+        ELOG("workspace_prewarm must not be negative, ignoring\n");
+        return;
+    }
+    config.workspace_prewarm = budget_mb;
+}
+
 CFGFUN(fake_outputs, const char *outputs) {
     config.fake_outputs = sstrdup(outputs);
 }
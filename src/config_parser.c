@@ -28,6 +28,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <unistd.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -65,11 +66,22 @@ typedef struct token {
     union {
         uint16_t call_identifier;
     } extra;
+    /* Determined by generate-command-parser.pl, so that we don’t need to
+     * compare token names while parsing. */
+    cmdp_token_kind kind;
+    /* For literals: the length of the literal and its first character in
+     * lowercase. */
+    int name_len;
+    int first;
 } cmdp_token;
 
 typedef struct tokenptr {
     cmdp_token *array;
     int n;
+    /* For states with many literals: the index of the first token which can
+     * match input starting with the given (lowercase, ASCII) character. NULL
+     * for all other states. */
+    const uint8_t *dispatch;
 } cmdp_token_ptr;
 
 #include "GENERATED_config_tokens.h"
@@ -350,15 +362,18 @@ struct ConfigResultIR *parse_config(const char *input, struct context *context)
 
         cmdp_token_ptr *ptr = &(tokens[state]);
         token_handled = false;
-        for (c = 0; c < ptr->n; c++) {
+        const int first = tolower((unsigned char)*walk);
+        c = (ptr->dispatch != NULL ? ptr->dispatch[first < 128 ? first : 0] : 0);
+        for (; c < ptr->n; c++) {
             token = &(ptr->array[c]);
 
             /* A literal. */
-            if (token->name[0] == '\'') {
-                if (strncasecmp(walk, token->name + 1, strlen(token->name) - 1) == 0) {
+            if (token->kind == TK_LITERAL) {
+                if (token->first == first &&
+                    strncasecmp(walk, token->name + 1, token->name_len) == 0) {
                     if (token->identifier != NULL)
                         push_string(token->identifier, token->name + 1);
-                    walk += strlen(token->name) - 1;
+                    walk += token->name_len;
                     next_state(token);
                     token_handled = true;
                     break;
@@ -366,7 +381,7 @@ struct ConfigResultIR *parse_config(const char *input, struct context *context)
                 continue;
             }
 
-            if (strcmp(token->name, "number") == 0) {
+            if (token->kind == TK_NUMBER) {
                 /* Handle numbers. We only accept decimal numbers for now. */
                 char *end = NULL;
                 errno = 0;
@@ -389,8 +404,7 @@ struct ConfigResultIR *parse_config(const char *input, struct context *context)
                 break;
             }
 
-            if (strcmp(token->name, "string") == 0 ||
-                strcmp(token->name, "word") == 0) {
+            if (token->kind == TK_STRING || token->kind == TK_WORD) {
                 const char *beginning = walk;
                 /* Handle quoted strings (or words). */
                 if (*walk == '"') {
@@ -399,7 +413,7 @@ struct ConfigResultIR *parse_config(const char *input, struct context *context)
                     while (*walk != '\0' && (*walk != '"' || *(walk - 1) == '\\'))
                         walk++;
                 } else {
-                    if (token->name[0] == 's') {
+                    if (token->kind == TK_STRING) {
                         while (*walk != '\0' && *walk != '\r' && *walk != '\n')
                             walk++;
                     } else {
@@ -440,7 +454,7 @@ struct ConfigResultIR *parse_config(const char *input, struct context *context)
                 }
             }
 
-            if (strcmp(token->name, "line") == 0) {
+            if (token->kind == TK_LINE) {
                 while (*walk != '\0' && *walk != '\n' && *walk != '\r')
                     walk++;
                 next_state(token);
@@ -450,7 +464,7 @@ struct ConfigResultIR *parse_config(const char *input, struct context *context)
                 break;
             }
 
-            if (strcmp(token->name, "end") == 0) {
+            if (token->kind == TK_END) {
                 //printf("checking for end: *%s*\n", walk);
                 if (*walk == '\0' || *walk == '\n' || *walk == '\r') {
                     next_state(token);
@@ -495,7 +509,7 @@ struct ConfigResultIR *parse_config(const char *input, struct context *context)
                 } else {
                     /* Skip error tokens in error messages, they are used
                      * internally only and might confuse users. */
-                    if (strcmp(token->name, "error") == 0)
+                    if (token->kind == TK_ERROR)
                         continue;
                     /* Any other token is copied to the error message enclosed
                      * with angle brackets. */
@@ -592,7 +606,7 @@ struct ConfigResultIR *parse_config(const char *input, struct context *context)
             for (int i = statelist_idx - 1; (i >= 0) && !error_token_found; i--) {
                 cmdp_token_ptr *errptr = &(tokens[statelist[i]]);
                 for (int j = 0; j < errptr->n; j++) {
-                    if (strcmp(errptr->array[j].name, "error") != 0)
+                    if (errptr->array[j].kind != TK_ERROR)
                         continue;
                     next_state(&(errptr->array[j]));
                     error_token_found = true;
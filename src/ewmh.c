@@ -11,14 +11,57 @@
  */
 #include "all.h"
 
+/* The desktop hints which need to be recomputed by
+ * ewmh_flush_hints(). */
+enum {
+    HINT_CURRENT_DESKTOP = (1 << 0),
+    HINT_NUMBER_OF_DESKTOPS = (1 << 1),
+    HINT_DESKTOP_NAMES = (1 << 2),
+    HINT_DESKTOP_VIEWPORT = (1 << 3)
+};
+static int pending_hints;
+
+/* The containers whose window needs its _NET_WM_DESKTOP and _NET_WM_STATE
+ * recomputed by ewmh_flush_hints(). */
+static TAILQ_HEAD(ewmh_pending_head, Con) pending_cons =
+    TAILQ_HEAD_INITIALIZER(pending_cons);
+
+/* The value which was last written to a root window property. */
+struct hint_cache {
+    bool valid;
+    size_t len;
+    void *value;
+};
+static struct hint_cache current_desktop_cache;
+static struct hint_cache number_of_desktops_cache;
+static struct hint_cache desktop_names_cache;
+static struct hint_cache desktop_viewport_cache;
+
 /*
- * Updates _NET_CURRENT_DESKTOP with the current desktop number.
+ * Stores the given value in the cache. Returns false if the cache already
+ * contained the same value, in which case the property does not need to be
+ * written again.
  *
- * EWMH: The index of the current desktop. This is always an integer between 0
- * and _NET_NUMBER_OF_DESKTOPS - 1.
+ */
+static bool hint_cache_update(struct hint_cache *cache, const void *value, size_t len) {
+    if (cache->valid && cache->len == len &&
+        (len == 0 || memcmp(cache->value, value, len) == 0))
+        return false;
+
+    if (len > 0) {
+        cache->value = srealloc(cache->value, len);
+        memcpy(cache->value, value, len);
+    }
+    cache->len = len;
+    cache->valid = true;
+    return true;
+}
+
+/*
+ * Writes _NET_CURRENT_DESKTOP, see ewmh_update_current_desktop().
  *
  */
-void ewmh_update_current_desktop(void) {
+static void write_current_desktop(void) {
     Con *focused_ws = con_get_workspace(focused);
     Con *output;
     uint32_t idx = 0;
@@ -31,8 +74,9 @@ void ewmh_update_current_desktop(void) {
                 continue;
 
             if (ws == focused_ws) {
-                xcb_change_property(conn, XCB_PROP_MODE_REPLACE, root,
-                                    A__NET_CURRENT_DESKTOP, XCB_ATOM_CARDINAL, 32, 1, &idx);
+                if (hint_cache_update(&current_desktop_cache, &idx, sizeof(idx)))
+                    xcb_change_property(conn, XCB_PROP_MODE_REPLACE, root,
+                                        A__NET_CURRENT_DESKTOP, XCB_ATOM_CARDINAL, 32, 1, &idx);
                 return;
             }
             ++idx;
@@ -41,10 +85,10 @@ void ewmh_update_current_desktop(void) {
 }
 
 /*
- * Updates _NET_NUMBER_OF_DESKTOPS which we interpret as the number of
- * noninternal workspaces.
+ * Writes _NET_NUMBER_OF_DESKTOPS, see ewmh_update_number_of_desktops().
+ *
  */
-void ewmh_update_number_of_desktops(void) {
+static void write_number_of_desktops(void) {
     Con *output;
     uint32_t idx = 0;
 
@@ -57,15 +101,19 @@ void ewmh_update_number_of_desktops(void) {
         }
     }
 
+    if (!hint_cache_update(&number_of_desktops_cache, &idx, sizeof(idx)))
+        return;
+
     xcb_change_property(conn, XCB_PROP_MODE_REPLACE, root,
                         A__NET_NUMBER_OF_DESKTOPS, XCB_ATOM_CARDINAL, 32, 1, &idx);
 }
 
 /*
- * Updates _NET_DESKTOP_NAMES: "The names of all virtual desktops. This is a
- * list of NULL-terminated strings in UTF-8 encoding"
+ * Writes _NET_DESKTOP_NAMES, see ewmh_update_desktop_names(). Returns true if
+ * the list of desktops changed.
+ *
  */
-void ewmh_update_desktop_names(void) {
+static bool write_desktop_names(void) {
     Con *output;
     int msg_length = 0;
 
@@ -95,15 +143,19 @@ void ewmh_update_desktop_names(void) {
         }
     }
 
+    if (!hint_cache_update(&desktop_names_cache, desktop_names, msg_length))
+        return false;
+
     xcb_change_property(conn, XCB_PROP_MODE_REPLACE, root,
                         A__NET_DESKTOP_NAMES, A_UTF8_STRING, 8, msg_length, desktop_names);
+    return true;
 }
 
 /*
- * Updates _NET_DESKTOP_VIEWPORT, which is an array of pairs of cardinals that
- * define the top left corner of each desktop's viewport.
+ * Writes _NET_DESKTOP_VIEWPORT, see ewmh_update_desktop_viewport().
+ *
  */
-void ewmh_update_desktop_viewport(void) {
+static void write_desktop_viewport(void) {
     Con *output;
     int num_desktops = 0;
     /* count number of desktops */
@@ -132,10 +184,179 @@ void ewmh_update_desktop_viewport(void) {
         }
     }
 
+    if (!hint_cache_update(&desktop_viewport_cache, viewports, current_position * sizeof(uint32_t)))
+        return;
+
     xcb_change_property(conn, XCB_PROP_MODE_REPLACE, root,
                         A__NET_DESKTOP_VIEWPORT, XCB_ATOM_CARDINAL, 32, current_position, &viewports);
 }
 
+/*
+ * Updates _NET_CURRENT_DESKTOP with the current desktop number.
+ *
+ * EWMH: The index of the current desktop. This is always an integer between 0
+ * and _NET_NUMBER_OF_DESKTOPS - 1.
+ *
+ * Like the other desktop hints, the property is only written by the next
+ * ewmh_flush_hints() and only if its value changed.
+ *
+ */
+void ewmh_update_current_desktop(void) {
+    pending_hints |= HINT_CURRENT_DESKTOP;
+}
+
+/*
+ * Updates _NET_NUMBER_OF_DESKTOPS which we interpret as the number of
+ * noninternal workspaces.
+ */
+void ewmh_update_number_of_desktops(void) {
+    pending_hints |= HINT_NUMBER_OF_DESKTOPS;
+}
+
+/*
+ * Updates _NET_DESKTOP_NAMES: "The names of all virtual desktops. This is a
+ * list of NULL-terminated strings in UTF-8 encoding"
+ */
+void ewmh_update_desktop_names(void) {
+    pending_hints |= HINT_DESKTOP_NAMES;
+}
+
+/*
+ * Updates _NET_DESKTOP_VIEWPORT, which is an array of pairs of cardinals that
+ * define the top left corner of each desktop's viewport.
+ */
+void ewmh_update_desktop_viewport(void) {
+    pending_hints |= HINT_DESKTOP_VIEWPORT;
+}
+
+/*
+ * Returns the desktop number of the given workspace (as used for
+ * _NET_CURRENT_DESKTOP), or NET_WM_DESKTOP_NONE for internal workspaces.
+ *
+ */
+static uint32_t desktop_index(Con *workspace) {
+    if (workspace == NULL || STARTS_WITH(workspace->name, "__"))
+        return NET_WM_DESKTOP_NONE;
+
+    Con *output;
+    uint32_t idx = 0;
+    TAILQ_FOREACH(output, &(croot->nodes_head), nodes) {
+        Con *ws;
+        TAILQ_FOREACH(ws, &(output_get_content(output)->nodes_head), nodes) {
+            if (STARTS_WITH(ws->name, "__"))
+                continue;
+
+            if (ws == workspace)
+                return idx;
+            ++idx;
+        }
+    }
+    return NET_WM_DESKTOP_NONE;
+}
+
+/*
+ * Writes _NET_WM_DESKTOP and _NET_WM_STATE of the window of the given
+ * container, if they differ from what was last written to it.
+ *
+ */
+static void write_window_hints(Con *con) {
+    i3Window *window = con->window;
+
+    uint32_t desktop = desktop_index(con_get_workspace(con));
+    if (desktop != window->wm_desktop) {
+        DLOG("_NET_WM_DESKTOP of window 0x%08x changed to %d\n", window->id, desktop);
+        if (desktop == NET_WM_DESKTOP_NONE)
+            xcb_delete_property(conn, window->id, A__NET_WM_DESKTOP);
+        else
+            xcb_change_property(conn, XCB_PROP_MODE_REPLACE, window->id,
+                                A__NET_WM_DESKTOP, XCB_ATOM_CARDINAL, 32, 1, &desktop);
+        window->wm_desktop = desktop;
+    }
+
+    uint32_t values[2];
+    unsigned int num = 0;
+    int state = 0;
+    if (con->fullscreen_mode != CF_NONE) {
+        values[num++] = A__NET_WM_STATE_FULLSCREEN;
+        state |= WM_STATE_FULLSCREEN;
+    }
+    if (con->urgent) {
+        values[num++] = A__NET_WM_STATE_DEMANDS_ATTENTION;
+        state |= WM_STATE_DEMANDS_ATTENTION;
+    }
+
+    if (state != window->wm_state) {
+        xcb_change_property(conn, XCB_PROP_MODE_REPLACE, window->id,
+                            A__NET_WM_STATE, XCB_ATOM_ATOM, 32, num, values);
+        window->wm_state = state;
+    }
+}
+
+/*
+ * Marks the windows of the given container and all of its children for an
+ * update of _NET_WM_DESKTOP and _NET_WM_STATE by the next ewmh_flush_hints().
+ * Called whenever a container is attached somewhere else or its fullscreen
+ * mode or urgency changes. Windows whose hints did not change are not written.
+ *
+ */
+void ewmh_update_window_hints(Con *con) {
+    if (con->window != NULL && !con->ewmh_pending) {
+        con->ewmh_pending = true;
+        TAILQ_INSERT_TAIL(&pending_cons, con, ewmh_pending_cons);
+    }
+
+    Con *child;
+    TAILQ_FOREACH(child, &(con->nodes_head), nodes)
+    ewmh_update_window_hints(child);
+    TAILQ_FOREACH(child, &(con->floating_head), floating_windows)
+    ewmh_update_window_hints(child);
+}
+
+/*
+ * Removes the given container from the pending window hint updates. Called
+ * before the container is freed.
+ *
+ */
+void ewmh_forget_con(Con *con) {
+    if (!con->ewmh_pending)
+        return;
+
+    TAILQ_REMOVE(&pending_cons, con, ewmh_pending_cons);
+    con->ewmh_pending = false;
+}
+
+/*
+ * Writes the desktop hints and the per-window hints which were updated since
+ * the last call, skipping those whose value did not change. Called once per
+ * event loop iteration (before flushing the X11 connection), so that a
+ * command which switches through several workspaces or moves several windows
+ * results in at most one write of each property.
+ *
+ */
+void ewmh_flush_hints(void) {
+    if (pending_hints != 0) {
+        if (pending_hints & HINT_NUMBER_OF_DESKTOPS)
+            write_number_of_desktops();
+        /* When the list of desktops changed, the desktop number of windows on
+         * other workspaces might have changed, too. */
+        if ((pending_hints & HINT_DESKTOP_NAMES) && write_desktop_names())
+            ewmh_update_window_hints(croot);
+        if (pending_hints & HINT_DESKTOP_VIEWPORT)
+            write_desktop_viewport();
+        if (pending_hints & HINT_CURRENT_DESKTOP)
+            write_current_desktop();
+
+        pending_hints = 0;
+    }
+
+    while (!TAILQ_EMPTY(&pending_cons)) {
+        Con *con = TAILQ_FIRST(&pending_cons);
+        ewmh_forget_con(con);
+        if (con->window != NULL)
+            write_window_hints(con);
+    }
+}
+
 /*
  * Updates _NET_ACTIVE_WINDOW with the currently focused window.
  *
@@ -27,52 +27,79 @@ static Output *get_screen_at(unsigned int x, unsigned int y) {
     return NULL;
 }
 
+/*
+ * Adds a fake output at the given position, or shrinks the existing one at
+ * this position (so that the user can always see the complete workspace).
+ *
+ */
+static void fake_output_add(unsigned int x, unsigned int y, unsigned int width, unsigned int height) {
+    DLOG("Parsed output as width = %u, height = %u at (%u, %u)\n",
+         width, height, x, y);
+    Output *new_output = get_screen_at(x, y);
+    if (new_output != NULL) {
+        DLOG("Re-used old output %p\n", new_output);
+        /* This screen already exists. We use the littlest screen so that the user
+           can always see the complete workspace */
+        new_output->rect.width = min(new_output->rect.width, width);
+        new_output->rect.height = min(new_output->rect.height, height);
+    } else {
+        new_output = scalloc(sizeof(Output));
+        sasprintf(&(new_output->name), "fake-%d", num_screens);
+        DLOG("Created new fake output %s (%p)\n", new_output->name, new_output);
+        new_output->active = true;
+        new_output->rect.x = x;
+        new_output->rect.y = y;
+        new_output->rect.width = width;
+        new_output->rect.height = height;
+        /* We always treat the screen at 0x0 as the primary screen */
+        if (new_output->rect.x == 0 && new_output->rect.y == 0)
+            TAILQ_INSERT_HEAD(&outputs, new_output, outputs);
+        else
+            TAILQ_INSERT_TAIL(&outputs, new_output, outputs);
+        output_init_con(new_output);
+        init_ws_for_output(new_output, output_get_content(new_output->con));
+        num_screens++;
+    }
+}
+
 /*
  * Creates outputs according to the given specification.
  * The specification must be in the format wxh+x+y, for example 1024x768+0+0,
  * with multiple outputs separated by commas:
  *   1900x1200+0+0,1280x1024+1900+0
  *
+ * A grid of equally sized outputs can be specified as colsxrows@wxh, for
+ * example 4x4@3840x2160 for a video wall of 16 4K outputs. The outputs of a
+ * grid are named row by row, starting at the top left.
+ *
  */
 void fake_outputs_init(const char *output_spec) {
-    char useless_buffer[1024];
     const char *walk = output_spec;
-    unsigned int x, y, width, height;
-    while (sscanf(walk, "%ux%u+%u+%u", &width, &height, &x, &y) == 4) {
-        DLOG("Parsed output as width = %u, height = %u at (%u, %u)\n",
-             width, height, x, y);
-        Output *new_output = get_screen_at(x, y);
-        if (new_output != NULL) {
-            DLOG("Re-used old output %p\n", new_output);
-            /* This screen already exists. We use the littlest screen so that the user
-               can always see the complete workspace */
-            new_output->rect.width = min(new_output->rect.width, width);
-            new_output->rect.height = min(new_output->rect.height, height);
-        } else {
-            new_output = scalloc(sizeof(Output));
-            sasprintf(&(new_output->name), "fake-%d", num_screens);
-            DLOG("Created new fake output %s (%p)\n", new_output->name, new_output);
-            new_output->active = true;
-            new_output->rect.x = x;
-            new_output->rect.y = y;
-            new_output->rect.width = width;
-            new_output->rect.height = height;
-            /* We always treat the screen at 0x0 as the primary screen */
-            if (new_output->rect.x == 0 && new_output->rect.y == 0)
-                TAILQ_INSERT_HEAD(&outputs, new_output, outputs);
-            else
-                TAILQ_INSERT_TAIL(&outputs, new_output, outputs);
-            output_init_con(new_output);
-            init_ws_for_output(new_output, output_get_content(new_output->con));
-            num_screens++;
-        }
+    unsigned int x, y, width, height, cols, rows;
+    int len;
+    while (true) {
+        if (sscanf(walk, "%ux%u@%ux%u%n", &cols, &rows, &width, &height, &len) == 4) {
+            DLOG("Parsed output grid of %u x %u outputs of %u x %u\n",
+                 cols, rows, width, height);
+            for (unsigned int row = 0; row < rows; row++)
+                for (unsigned int col = 0; col < cols; col++)
+                    fake_output_add(col * width, row * height, width, height);
+        } else if (sscanf(walk, "%ux%u+%u+%u%n", &width, &height, &x, &y, &len) == 4) {
+            fake_output_add(x, y, width, height);
+        } else
+            break;
 
-        /* Figure out how long the input was to skip it */
-        walk += sprintf(useless_buffer, "%ux%u+%u+%u", width, height, x, y) + 1;
+        /* Skip the parsed output and the separator */
+        walk += len;
+        if (*walk != ',')
+            break;
+        walk++;
     }
 
     if (num_screens == 0) {
         ELOG("No screens found. Please fix your setup. i3 will exit now.\n");
         exit(0);
     }
+
+    randr_update_output_index();
 }
@@ -0,0 +1,255 @@
+#undef I3__FILE__
+#define I3__FILE__ "focus_index.c"
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * focus_index.c: Per-workspace index of the rendered tiling containers, used
+ *                to find the nearest container in a direction for
+ *                'directional_focus geometric'.
+ *
+ */
+#include "all.h"
+
+struct focus_index_entry {
+    Con *con;
+    Rect rect;
+};
+
+struct focus_index {
+    /* Cleared when containers are attached to or detached from the
+     * workspace, set again when it is rendered. */
+    bool valid;
+
+    int num;
+    int capacity;
+    struct focus_index_entry *entries;
+
+    /* The entries sorted by the edge which faces a container looking in the
+     * given direction, i.e. by_direction[D_RIGHT] is sorted by the left edge,
+     * by_direction[D_LEFT] by the right edge and so on. */
+    struct focus_index_entry **by_direction[4];
+};
+
+/*
+ * Returns the edge of the given rect which is hit first when coming from the
+ * opposite side, moving in the given direction.
+ *
+ */
+static int near_edge(const Rect *rect, direction_t direction) {
+    switch (direction) {
+        case D_RIGHT:
+            return rect->x;
+        case D_LEFT:
+            return rect->x + rect->width;
+        case D_DOWN:
+            return rect->y;
+        case D_UP:
+            return rect->y + rect->height;
+    }
+    return 0;
+}
+
+/*
+ * Returns the edge of the given rect which is left behind when moving in the
+ * given direction.
+ *
+ */
+static int far_edge(const Rect *rect, direction_t direction) {
+    switch (direction) {
+        case D_RIGHT:
+            return rect->x + rect->width;
+        case D_LEFT:
+            return rect->x;
+        case D_DOWN:
+            return rect->y + rect->height;
+        case D_UP:
+            return rect->y;
+    }
+    return 0;
+}
+
+/* The direction by which the entries are sorted in focus_index_cmp(). qsort()
+ * does not take a context argument and i3 is single-threaded, so a static
+ * variable is fine. */
+static direction_t sort_direction;
+
+static int focus_index_cmp(const void *a, const void *b) {
+    const struct focus_index_entry *first = *(struct focus_index_entry *const *)a;
+    const struct focus_index_entry *second = *(struct focus_index_entry *const *)b;
+    int first_edge = near_edge(&(first->rect), sort_direction);
+    int second_edge = near_edge(&(second->rect), sort_direction);
+    return (first_edge > second_edge) - (first_edge < second_edge);
+}
+
+/*
+ * Adds the tiling containers below the given container to the index. Split
+ * containers are descended into, whereas stacked and tabbed containers are
+ * added as a whole, because only one of their children is visible.
+ *
+ */
+static void focus_index_collect(struct focus_index *index, Con *con) {
+    Con *child;
+    TAILQ_FOREACH(child, &(con->nodes_head), nodes) {
+        if (!con_is_leaf(child) &&
+            child->layout != L_STACKED &&
+            child->layout != L_TABBED) {
+            focus_index_collect(index, child);
+            continue;
+        }
+
+        if (index->num == index->capacity) {
+            index->capacity = (index->capacity == 0 ? 16 : index->capacity * 2);
+            index->entries = srealloc(index->entries, index->capacity * sizeof(struct focus_index_entry));
+            for (int d = 0; d < 4; d++)
+                index->by_direction[d] = srealloc(index->by_direction[d], index->capacity * sizeof(struct focus_index_entry *));
+        }
+        index->entries[index->num].con = child;
+        index->entries[index->num].rect = child->rect;
+        index->num++;
+    }
+}
+
+/*
+ * (Re-)builds the focus index of the given workspace from the rects of its
+ * tiling containers. Called after the workspace was rendered.
+ *
+ */
+void focus_index_update(Con *ws) {
+    struct focus_index *index = ws->focus_index;
+    if (index == NULL)
+        index = ws->focus_index = scalloc(sizeof(struct focus_index));
+
+    index->num = 0;
+    /* When the workspace itself is stacked or tabbed, there is nothing to
+     * navigate geometrically. */
+    if (ws->layout != L_STACKED && ws->layout != L_TABBED)
+        focus_index_collect(index, ws);
+
+    for (int d = 0; d < 4; d++) {
+        for (int i = 0; i < index->num; i++)
+            index->by_direction[d][i] = &(index->entries[i]);
+        sort_direction = d;
+        qsort(index->by_direction[d], index->num, sizeof(struct focus_index_entry *), focus_index_cmp);
+    }
+
+    index->valid = true;
+}
+
+/*
+ * Marks the focus index of the workspace containing the given container as
+ * outdated, so that it will not be used until the next render. Called
+ * whenever containers are attached to or detached from a workspace.
+ *
+ */
+void focus_index_invalidate(Con *con) {
+    Con *ws = con_get_workspace(con);
+    if (ws != NULL && ws->focus_index != NULL)
+        ws->focus_index->valid = false;
+}
+
+/*
+ * Frees the focus index of the given workspace (if any).
+ *
+ */
+void focus_index_free(Con *ws) {
+    struct focus_index *index = ws->focus_index;
+    if (index == NULL)
+        return;
+
+    for (int d = 0; d < 4; d++)
+        free(index->by_direction[d]);
+    free(index->entries);
+    FREE(ws->focus_index);
+}
+
+/*
+ * Returns the container which is nearest to the given one in the given
+ * direction on the same workspace, or NULL if there is none or the index
+ * cannot answer (e.g. for floating containers, containers inside a stacked
+ * or tabbed container or when the index is outdated). In the latter cases,
+ * the caller falls back to walking the tree.
+ *
+ */
+Con *focus_index_next(Con *con, direction_t direction) {
+    Con *ws = con_get_workspace(con);
+    if (ws == NULL || con == ws)
+        return NULL;
+
+    struct focus_index *index = ws->focus_index;
+    if (index == NULL || !index->valid)
+        return NULL;
+
+    if (con_get_fullscreen_con(croot, CF_GLOBAL) ||
+        con_get_fullscreen_con(ws, CF_OUTPUT))
+        return NULL;
+
+    /* The rect of the container is only comparable to the indexed ones if
+     * all of its parents are split containers. */
+    for (Con *parent = con->parent; parent != ws; parent = parent->parent) {
+        if (parent->type != CT_CON ||
+            parent->layout == L_STACKED ||
+            parent->layout == L_TABBED)
+            return NULL;
+    }
+    if (con->type != CT_CON ||
+        ws->layout == L_STACKED ||
+        ws->layout == L_TABBED)
+        return NULL;
+
+    const bool forward = (direction == D_RIGHT || direction == D_DOWN);
+    const bool horizontal = (direction == D_LEFT || direction == D_RIGHT);
+    const int edge = far_edge(&(con->rect), direction);
+    struct focus_index_entry **sorted = index->by_direction[direction];
+
+    /* Binary search for the first entry (in the direction we are looking)
+     * which lies entirely beyond the edge of the container. */
+    int low = 0, high = index->num;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        int mid_edge = near_edge(&(sorted[mid]->rect), direction);
+        if (forward ? mid_edge < edge : mid_edge <= edge)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    /* Walk away from the container until the entries are further away than
+     * the best match found so far. Only entries which overlap with the
+     * container on the other axis are candidates, of those the one whose
+     * center is closest to the center of the container wins. */
+    const int center = (horizontal ? con->rect.y + con->rect.height / 2
+                                   : con->rect.x + con->rect.width / 2);
+    struct focus_index_entry *best = NULL;
+    int best_distance = 0, best_offset = 0;
+    for (int i = (forward ? low : low - 1);
+         i >= 0 && i < index->num;
+         i += (forward ? 1 : -1)) {
+        struct focus_index_entry *entry = sorted[i];
+        int distance = abs(near_edge(&(entry->rect), direction) - edge);
+        if (best != NULL && distance > best_distance)
+            break;
+
+        int start = (horizontal ? entry->rect.y : entry->rect.x);
+        int size = (horizontal ? entry->rect.height : entry->rect.width);
+        int con_start = (horizontal ? con->rect.y : con->rect.x);
+        int con_size = (horizontal ? con->rect.height : con->rect.width);
+        if (start >= con_start + con_size || start + size <= con_start)
+            continue;
+
+        int offset = abs(start + size / 2 - center);
+        if (best == NULL || distance < best_distance || offset < best_offset) {
+            best = entry;
+            best_distance = distance;
+            best_offset = offset;
+        }
+    }
+
+    if (best == NULL)
+        return NULL;
+
+    DLOG("Nearest container in direction %d of %p is %p\n", direction, con, best->con);
+    return best->con;
+}
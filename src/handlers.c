@@ -38,9 +38,36 @@ static SLIST_HEAD(ignore_head, Ignore_Event) ignore_events;
  *
  */
 void add_ignore_event(const int sequence, const int response_type) {
-    struct Ignore_Event *event = smalloc(sizeof(struct Ignore_Event));
+    add_ignore_event_range(sequence, sequence, response_type);
+}
+
+/*
+ * Like add_ignore_event(), but ignores all events with a sequence number
+ * between first and last (inclusive). Events carry the sequence number of
+ * the last request the X server processed before generating them, so this
+ * ignores all events caused by the requests sent in between.
+ *
+ * A range which overlaps or directly follows the most recently added one (of
+ * the same response_type) is merged into it, so that frequent renders do not
+ * pile up entries.
+ *
+ */
+void add_ignore_event_range(const int first, const int last, const int response_type) {
+    struct Ignore_Event *event = SLIST_FIRST(&ignore_events);
+    if (event != SLIST_END(&ignore_events) &&
+        event->response_type == response_type &&
+        (uint16_t)(first - event->sequence) <= (uint16_t)(event->last_sequence - event->sequence + 1) &&
+        (uint16_t)(last - event->sequence) < 0x8000) {
+        if ((uint16_t)(last - event->sequence) > (uint16_t)(event->last_sequence - event->sequence))
+            event->last_sequence = last;
+        event->added = time(NULL);
+        return;
+    }
+
+    event = smalloc(sizeof(struct Ignore_Event));
 
-    event->sequence = sequence;
+    event->sequence = first;
+    event->last_sequence = last;
     event->response_type = response_type;
     event->added = time(NULL);
 
@@ -55,7 +82,11 @@ bool event_is_ignored(const int sequence, const int response_type) {
     struct Ignore_Event *event;
     time_t now = time(NULL);
     for (event = SLIST_FIRST(&ignore_events); event != SLIST_END(&ignore_events);) {
-        if ((now - event->added) > 5) {
+        /* Events arrive in the order of their sequence numbers, so once an
+         * event after the end of a range arrived, the range cannot match
+         * anymore and is garbage collected right away. */
+        if ((now - event->added) > 5 ||
+            (int16_t)(sequence - event->last_sequence) > 0) {
             struct Ignore_Event *save = event;
             event = SLIST_NEXT(event, ignore_events);
             SLIST_REMOVE(&ignore_events, save, Ignore_Event, ignore_events);
@@ -65,7 +96,10 @@ bool event_is_ignored(const int sequence, const int response_type) {
     }
 
     SLIST_FOREACH(event, &ignore_events, ignore_events) {
-        if (event->sequence != sequence)
+        /* Events only contain the lower 16 bits of the sequence number, so we
+         * compare modulo 2^16 (which also handles wrap-around in ranges). */
+        if ((uint16_t)(sequence - event->sequence) >
+            (uint16_t)(event->last_sequence - event->sequence))
             continue;
 
         if (event->response_type != -1 &&
@@ -442,7 +476,10 @@ static void handle_screen_change(xcb_generic_event_t *e) {
     croot->rect.width = reply->width;
     croot->rect.height = reply->height;
 
-    randr_query_outputs();
+    if (!randr_query_outputs()) {
+        DLOG("Outputs unchanged, ignoring RandR screen change\n");
+        return;
+    }
 
     scratchpad_fix_resolution();
 
@@ -486,8 +523,12 @@ static void handle_unmap_notify_event(xcb_unmap_notify_event_t *event) {
         goto ignore_end;
     }
 
+    /* Windows which were killed in bulk are rendered once the last of them
+     * is gone (see tree_close_many()). */
+    const bool defer_render = tree_close_defers_render(con);
     tree_close(con, DONT_KILL_WINDOW, false, false);
-    tree_render();
+    if (!defer_render)
+        tree_render();
 
 ignore_end:
     /* If the client (as opposed to i3) destroyed or unmapped a window, an
@@ -761,6 +802,12 @@ static void handle_client_message(xcb_client_message_event_t *event) {
         uint32_t rnd = event->data.data32[1];
         DLOG("[i3 sync protocol] Sending random value %d back to X11 window 0x%08x\n", rnd, window);
 
+        /* Clients use the sync protocol to wait until i3 has processed all
+         * previous requests, which includes updating the EWMH hints and
+         * sending the resulting IPC events. */
+        ipc_flush_events();
+        ewmh_flush_hints();
+
         void *reply = scalloc(32);
         xcb_client_message_event_t *ev = reply;
 
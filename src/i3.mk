@@ -38,9 +38,16 @@ src/%.o: src/%.c $(i3_HEADERS_DEP)
 
 test-tools: test.commands_parser test.config_parser
 
+# The benchmark of test.commands_parser counts allocations by wrapping the
+# allocation functions, which needs a linker supporting --wrap (e.g. GNU ld,
+# but not ld64 on OS X).
+ifeq ($(shell echo 'int main(void) { return 0; }' | $(CC) -x c -Wl,--wrap=malloc -o /dev/null - 2>/dev/null && echo 1),1)
+COMMANDS_PARSER_TEST_FLAGS := -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=strdup -DCOUNT_ALLOCATIONS
+endif
+
 test.commands_parser: src/commands_parser.c $(i3_HEADERS_DEP) i3-command-parser.stamp libi3.a
 	echo "[i3] Link test.commands_parser"
-	$(CC) $(I3_CPPFLAGS) $(XCB_CPPFLAGS) $(CPPFLAGS) $(i3_CFLAGS) $(I3_CFLAGS) $(CFLAGS) $(I3_LDFLAGS) $(LDFLAGS) -DTEST_PARSER -g -o test.commands_parser $< $(LIBS) $(i3_LIBS)
+	$(CC) $(I3_CPPFLAGS) $(XCB_CPPFLAGS) $(CPPFLAGS) $(i3_CFLAGS) $(I3_CFLAGS) $(CFLAGS) $(I3_LDFLAGS) $(LDFLAGS) $(COMMANDS_PARSER_TEST_FLAGS) -DTEST_PARSER -g -o test.commands_parser $< $(LIBS) $(i3_LIBS)
 
 test.config_parser: src/config_parser.c $(i3_HEADERS_DEP) i3-config-parser.stamp libi3.a
 	echo "[i3] Link test.config_parser"
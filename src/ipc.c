@@ -11,6 +11,7 @@
  */
 #include "all.h"
 #include "yajl_utils.h"
+#include "encoder_utils.h"
 
 #include <sys/socket.h>
 #include <sys/un.h>
@@ -24,6 +25,80 @@ char *current_socketpath = NULL;
 
 TAILQ_HEAD(ipc_client_head, ipc_client) all_clients = TAILQ_HEAD_INITIALIZER(all_clients);
 
+/*
+ * Returns the client connected on the given file descriptor.
+ *
+ */
+static ipc_client *client_for_fd(int fd) {
+    ipc_client *current;
+    TAILQ_FOREACH(current, &all_clients, clients) {
+        if (current->fd == fd)
+            return current;
+    }
+    return NULL;
+}
+
+/*
+ * Sends a message to the given client. While a worker thread writes a reply
+ * to the client, the message is queued and sent by ipc_client_resume().
+ *
+ */
+static void client_send_message(ipc_client *client, uint32_t message_type, const uint8_t *payload, uint32_t size) {
+    if (!client->reply_pending) {
+        ipc_send_message(client->fd, size, message_type, payload);
+        return;
+    }
+
+    const i3_ipc_header_t header = {
+        .magic = {'i', '3', '-', 'i', 'p', 'c'},
+        .size = size,
+        .type = message_type};
+    client->queued_output = srealloc(client->queued_output, client->queued_output_length + sizeof(header) + size);
+    memcpy(client->queued_output + client->queued_output_length, &header, sizeof(header));
+    memcpy(client->queued_output + client->queued_output_length + sizeof(header), payload, size);
+    client->queued_output_length += sizeof(header) + size;
+}
+
+/*
+ * Called once a worker thread finished writing a reply to the client: sends
+ * the messages which were queued in the meantime and resumes reading
+ * messages from the client.
+ *
+ */
+void ipc_client_resume(ipc_client *client) {
+    client->reply_pending = false;
+    if (client->queued_output_length > 0)
+        writeall(client->fd, client->queued_output, client->queued_output_length);
+    FREE(client->queued_output);
+    client->queued_output_length = 0;
+    ev_io_start(main_loop, client->callback);
+}
+
+/*
+ * Closes the connection to the given client and frees it.
+ *
+ */
+void ipc_client_disconnect(ipc_client *client) {
+    close(client->fd);
+
+    for (int i = 0; i < client->num_events; i++)
+        free(client->events[i]);
+    FREE(client->events);
+    FREE(client->compact_events);
+    FREE(client->all_events);
+    FREE(client->queued_output);
+    if (client->ring != NULL)
+        ipc_ring_free(client->ring);
+
+    ev_io_stop(main_loop, client->callback);
+    free(client->callback);
+
+    TAILQ_REMOVE(&all_clients, client, clients);
+    free(client);
+
+    DLOG("IPC: client disconnected\n");
+}
+
 /*
  * Puts the given socket file descriptor into non-blocking mode or dies if
  * setting O_NONBLOCK failed. Non-blocking sockets are a good idea for our
@@ -67,26 +142,335 @@ bool mkdirp(const char *path) {
     return result;
 }
 
+/* An event which was emitted, but not yet sent to the clients. Events are
+ * queued while commands are executed and the tree is modified, and are sent
+ * by ipc_flush_events() once per event loop iteration (and before replying to
+ * a command), so that they describe the final state. */
+typedef struct ipc_pending_event {
+    const char *event;
+    uint32_t message_type;
+    char *change;
+
+    /* Whether the payloads of this workspace or window event still need to
+     * be generated from the containers (see marshal_pending_event()). */
+    bool marshal;
+    Con *con;
+    Con *old;
+    /* For workspace focus events which replaced earlier ones: the workspace
+     * which was focused before the first of them. Once that workspace is
+     * freed, it is kept in serialized form (indexed by [compact]). */
+    Con *first_old;
+    char *first_old_json[2];
+    bool has_coalesced_flavor;
+
+    /* Set when a later event of the same kind made this one redundant. Such
+     * events are only sent to clients which asked for every event. */
+    bool superseded;
+
+    /* The payloads, indexed by [compact][coalesced]. Events which are not
+     * generated from containers only use [compact][0]. */
+    char *payloads[2][2];
+
+    TAILQ_ENTRY(ipc_pending_event) pending_events;
+} ipc_pending_event;
+
+static TAILQ_HEAD(pending_events_head, ipc_pending_event) pending_events =
+    TAILQ_HEAD_INITIALIZER(pending_events);
+
+/*
+ * Checks whether the given client is subscribed to the given flavor (compact
+ * or full payload) of the given event. If so, *all is set to whether it asked
+ * for every event (in any of its subscriptions for this flavor).
+ *
+ */
+static bool client_is_subscribed(ipc_client *client, const char *event, bool compact, bool *all) {
+    bool subscribed = false;
+    *all = false;
+    for (int i = 0; i < client->num_events; i++) {
+        if (strcasecmp(client->events[i], event) != 0 ||
+            client->compact_events[i] != compact)
+            continue;
+        subscribed = true;
+        *all |= client->all_events[i];
+    }
+    return subscribed;
+}
+
+/*
+ * Returns true if at least one IPC client is subscribed to the given event
+ * with the given flavor (compact or full payload).
+ *
+ */
+bool ipc_has_event_subscribers(const char *event, bool compact) {
+    ipc_client *current;
+    TAILQ_FOREACH(current, &all_clients, clients) {
+        bool client_all;
+        if (client_is_subscribed(current, event, compact, &client_all))
+            return true;
+    }
+    return false;
+}
+
+/*
+ * Returns a copy of the payload of the given encoder and frees it.
+ *
+ */
+static char *payload_from_gen(ipc_encoder *gen) {
+    const unsigned char *buf;
+    ylength length;
+    y(get_buf, &buf, &length);
+    char *payload = smalloc(length + 1);
+    memcpy(payload, buf, length);
+    payload[length] = '\0';
+    y(free);
+    return payload;
+}
+
+static void dump_node_compact(ipc_encoder *gen, Con *con);
+static ipc_encoder *marshal_window_event(const char *property, Con *con, bool compact);
+static ipc_encoder *marshal_workspace_event(const char *change, Con *current, Con *old, const char *old_json, bool compact);
+
+/*
+ * Returns the given container serialized as it would be in an event.
+ *
+ */
+static char *marshal_con(Con *con, bool compact) {
+    setlocale(LC_NUMERIC, "C");
+    ipc_encoder *gen = ipc_encoder_new(IPC_ENCODING_JSON);
+    if (compact)
+        dump_node_compact(gen, con);
+    else
+        dump_node(gen, con, false);
+    setlocale(LC_NUMERIC, "");
+    return payload_from_gen(gen);
+}
+
 /*
- * Sends the specified event to all IPC clients which are currently connected
- * and subscribed to this kind of event.
+ * Generates the payload of a workspace or window event from the current state
+ * of its containers.
+ *
+ */
+static char *marshal_pending_event(ipc_pending_event *pending, bool compact, bool coalesced) {
+    if (pending->message_type == I3_IPC_EVENT_WINDOW)
+        return payload_from_gen(marshal_window_event(pending->change, pending->con, compact));
+
+    if (!coalesced)
+        return payload_from_gen(marshal_workspace_event(pending->change, pending->con, pending->old, NULL, compact));
+
+    return payload_from_gen(marshal_workspace_event(pending->change, pending->con, pending->first_old,
+                                                    pending->first_old_json[compact], compact));
+}
+
+/*
+ * Returns the payload of the given event in the requested flavor, generating
+ * it if necessary. If that flavor is not available (because the event has no
+ * compact flavor or the containers were already freed), another one is
+ * returned.
+ *
+ */
+static const char *get_payload(ipc_pending_event *pending, bool compact, bool coalesced) {
+    if (!pending->has_coalesced_flavor)
+        coalesced = false;
+
+    if (pending->payloads[compact][coalesced] == NULL && pending->marshal)
+        pending->payloads[compact][coalesced] = marshal_pending_event(pending, compact, coalesced);
+
+    const bool fallbacks[][2] = {{compact, coalesced}, {!compact, coalesced}, {compact, false}, {!compact, false}};
+    for (size_t i = 0; i < sizeof(fallbacks) / sizeof(fallbacks[0]); i++) {
+        char *payload = pending->payloads[fallbacks[i][0]][fallbacks[i][1]];
+        if (payload != NULL)
+            return payload;
+    }
+    return NULL;
+}
+
+/*
+ * Appends a new event to the queue, if any client is subscribed to it.
+ * Returns NULL otherwise.
+ *
+ */
+static ipc_pending_event *queue_event(const char *event, uint32_t message_type, const char *change) {
+    if (!ipc_has_event_subscribers(event, false) &&
+        !ipc_has_event_subscribers(event, true))
+        return NULL;
+
+    ipc_pending_event *pending = scalloc(sizeof(ipc_pending_event));
+    pending->event = event;
+    pending->message_type = message_type;
+    pending->change = (change != NULL ? sstrdup(change) : NULL);
+    TAILQ_INSERT_TAIL(&pending_events, pending, pending_events);
+    return pending;
+}
+
+/*
+ * Marks the queued events which are made redundant by the given workspace or
+ * window event as superseded: an earlier event with the same change for the
+ * same container, or any earlier focus event. A workspace focus event takes
+ * over the “old” workspace of the focus event it replaces, so that clients see
+ * a single switch from the first to the last workspace.
+ *
+ */
+static void coalesce_event(ipc_pending_event *pending) {
+    const bool is_focus = (strcmp(pending->change, "focus") == 0);
+    ipc_pending_event *earlier = TAILQ_PREV(pending, pending_events_head, pending_events);
+    for (; earlier != NULL; earlier = TAILQ_PREV(earlier, pending_events_head, pending_events)) {
+        if (earlier->superseded ||
+            earlier->change == NULL ||
+            earlier->message_type != pending->message_type ||
+            strcmp(earlier->change, pending->change) != 0)
+            continue;
+
+        /* Events of containers which were freed in the meantime cannot be
+         * compared, except for focus events. */
+        if (!is_focus && (!earlier->marshal || earlier->con != pending->con))
+            continue;
+
+        DLOG("IPC %s %s event superseded\n", earlier->event, earlier->change);
+        earlier->superseded = true;
+        if (is_focus && pending->message_type == I3_IPC_EVENT_WORKSPACE) {
+            pending->first_old = earlier->first_old;
+            for (int compact = 0; compact < 2; compact++) {
+                if (earlier->first_old_json[compact] != NULL)
+                    pending->first_old_json[compact] = sstrdup(earlier->first_old_json[compact]);
+            }
+            pending->has_coalesced_flavor = (pending->first_old != pending->old ||
+                                             pending->first_old_json[false] != NULL ||
+                                             pending->first_old_json[true] != NULL);
+        }
+        /* There is at most one event which was not yet superseded. */
+        return;
+    }
+}
+
+/*
+ * Queues the specified event for all IPC clients which are subscribed to this
+ * kind of event. It is sent by the next ipc_flush_events().
  *
  */
 void ipc_send_event(const char *event, uint32_t message_type, const char *payload) {
+    ipc_pending_event *pending = queue_event(event, message_type, NULL);
+    if (pending != NULL)
+        pending->payloads[false][false] = sstrdup(payload);
+}
+
+/*
+ * Queues the payloads of the given generators for all IPC clients subscribed
+ * to the event: clients which subscribed to the compact flavor get the payload
+ * of compact_gen, all others get the payload of gen. Either generator may be
+ * NULL if nobody wants that flavor. Frees both generators.
+ *
+ */
+void ipc_send_marshalled_event(const char *event, uint32_t message_type, ipc_encoder *gen, ipc_encoder *compact_gen) {
+    ipc_pending_event *pending = NULL;
+    if (gen != NULL || compact_gen != NULL)
+        pending = queue_event(event, message_type, NULL);
+
+    if (gen != NULL) {
+        if (pending != NULL)
+            pending->payloads[false][false] = payload_from_gen(gen);
+        else
+            y(free);
+    }
+    if (compact_gen != NULL) {
+        if (pending != NULL)
+            pending->payloads[true][false] = payload_from_gen(compact_gen);
+        else
+            ipc_encoder_free(compact_gen);
+    }
+}
+
+/*
+ * Frees the given event, which must not be queued anymore.
+ *
+ */
+static void free_pending_event(ipc_pending_event *pending) {
+    for (int compact = 0; compact < 2; compact++) {
+        for (int coalesced = 0; coalesced < 2; coalesced++)
+            free(pending->payloads[compact][coalesced]);
+    }
+    free(pending->first_old_json[false]);
+    free(pending->first_old_json[true]);
+    free(pending->change);
+    free(pending);
+}
+
+/*
+ * Sends all queued events to the subscribed clients, in the order in which
+ * they were emitted. Superseded events are skipped, unless the client asked
+ * for every event (by subscribing to e.g. "window:all").
+ *
+ */
+void ipc_flush_events(void) {
+    ipc_pending_event *pending;
+    while ((pending = TAILQ_FIRST(&pending_events)) != NULL) {
+        TAILQ_REMOVE(&pending_events, pending, pending_events);
+
+        ipc_client *current;
+        TAILQ_FOREACH(current, &all_clients, clients) {
+            /* A client which subscribed to both flavors gets both payloads. */
+            for (int compact = 0; compact < 2; compact++) {
+                bool all;
+                if (!client_is_subscribed(current, pending->event, compact, &all))
+                    continue;
+                if (pending->superseded && !all)
+                    continue;
+
+                const char *payload = get_payload(pending, compact, !all);
+                if (payload == NULL)
+                    continue;
+                if (current->ring != NULL)
+                    ipc_ring_write(current->ring, pending->message_type, payload, strlen(payload));
+                else
+                    client_send_message(current, pending->message_type, (const uint8_t *)payload, strlen(payload));
+            }
+        }
+
+        free_pending_event(pending);
+    }
+
+    /* Clients with a ring buffer only get a message on the socket when they
+     * might be waiting for one, i.e. at most once per batch of events. */
     ipc_client *current;
     TAILQ_FOREACH(current, &all_clients, clients) {
-        /* see if this client is interested in this event */
-        bool interested = false;
-        for (int i = 0; i < current->num_events; i++) {
-            if (strcasecmp(current->events[i], event) != 0)
-                continue;
-            interested = true;
-            break;
+        if (current->ring != NULL && ipc_ring_end_batch(current->ring))
+            client_send_message(current, I3_IPC_EVENT_RING_WAKEUP, (const uint8_t *)"", 0);
+    }
+}
+
+/*
+ * Generates the payloads of all queued events which refer to the given
+ * container, because it is about to be freed. Called by tree_close().
+ *
+ */
+void ipc_forget_con(Con *con) {
+    ipc_pending_event *pending;
+    TAILQ_FOREACH(pending, &pending_events, pending_events) {
+        if (!pending->marshal)
+            continue;
+
+        /* The first “old” workspace of coalesced focus events is kept in
+         * serialized form, so that a later focus event which replaces this
+         * one can still refer to it. */
+        if (pending->first_old == con) {
+            for (int compact = 0; compact < 2; compact++) {
+                if (ipc_has_event_subscribers(pending->event, compact))
+                    pending->first_old_json[compact] = marshal_con(con, compact);
+            }
+            pending->first_old = NULL;
         }
-        if (!interested)
+
+        if (pending->con != con && pending->old != con)
             continue;
 
-        ipc_send_message(current->fd, strlen(payload), message_type, (const uint8_t *)payload);
+        for (int compact = 0; compact < 2; compact++) {
+            if (!ipc_has_event_subscribers(pending->event, compact))
+                continue;
+            get_payload(pending, compact, false);
+            if (pending->has_coalesced_flavor)
+                get_payload(pending, compact, true);
+        }
+        pending->marshal = false;
+        pending->con = pending->old = NULL;
     }
 }
 
@@ -96,11 +480,24 @@ void ipc_send_event(const char *event, uint32_t message_type, const char *payloa
  *
  */
 void ipc_shutdown(void) {
+    /* Send the events which are still queued, e.g. for the “exit” command. */
+    ipc_flush_events();
+
     ipc_client *current;
+    TAILQ_FOREACH(current, &all_clients, clients)
+        shutdown(current->fd, SHUT_RDWR);
+
+    /* Worker threads might still be writing to the clients. Now that the
+     * sockets are shut down, they will give up quickly. */
+    ipc_worker_shutdown();
+
     while (!TAILQ_EMPTY(&all_clients)) {
         current = TAILQ_FIRST(&all_clients);
-        shutdown(current->fd, SHUT_RDWR);
         close(current->fd);
+        FREE(current->queued_output);
+        /* Unlink the shared memory objects, so that they do not outlive us. */
+        if (current->ring != NULL)
+            ipc_ring_free(current->ring);
         TAILQ_REMOVE(&all_clients, current, clients);
         free(current);
     }
@@ -119,6 +516,8 @@ IPC_HANDLER(command) {
     LOG("IPC: received: *%s*\n", command);
     yajl_gen gen = yajl_gen_alloc(NULL);
 
+    tree_snapshot_invalidate();
+
     CommandResult *result = parse_command((const char *)command, gen);
     free(command);
 
@@ -127,6 +526,10 @@ IPC_HANDLER(command) {
 
     command_result_free(result);
 
+    /* Send the events caused by the command before the reply, like they were
+     * when events were sent immediately. */
+    ipc_flush_events();
+
     const unsigned char *reply;
     ylength length;
     yajl_gen_get_buf(gen, &reply, &length);
@@ -137,7 +540,7 @@ IPC_HANDLER(command) {
     yajl_gen_free(gen);
 }
 
-static void dump_rect(yajl_gen gen, const char *name, Rect r) {
+static void dump_rect(ipc_encoder *gen, const char *name, Rect r) {
     ystr(name);
     y(map_open);
     ystr("x");
@@ -151,7 +554,7 @@ static void dump_rect(yajl_gen gen, const char *name, Rect r) {
     y(map_close);
 }
 
-static void dump_binding(yajl_gen gen, Binding *bind) {
+static void dump_binding(ipc_encoder *gen, Binding *bind) {
     y(map_open);
     ystr("input_code");
     y(integer, bind->keycode);
@@ -205,7 +608,7 @@ static void dump_binding(yajl_gen gen, Binding *bind) {
     y(map_close);
 }
 
-void dump_node(yajl_gen gen, struct Con *con, bool inplace_restart) {
+void dump_node(ipc_encoder *gen, struct Con *con, bool inplace_restart) {
     y(map_open);
     ystr("id");
     y(integer, (long int)con);
@@ -499,7 +902,43 @@ void dump_node(yajl_gen gen, struct Con *con, bool inplace_restart) {
     y(map_close);
 }
 
-static void dump_bar_config(yajl_gen gen, Barconfig *config) {
+/*
+ * Dumps only the identifying information of a container (id, name, window,
+ * workspace number and geometry) without recursing into its children. Used
+ * for events sent to clients which subscribed to the compact flavor; they can
+ * request the details with GET_TREE if needed.
+ *
+ */
+static void dump_node_compact(ipc_encoder *gen, Con *con) {
+    y(map_open);
+    ystr("id");
+    y(integer, (long int)con);
+
+    ystr("name");
+    if (con->window && con->window->name)
+        ystr(i3string_as_utf8(con->window->name));
+    else if (con->name != NULL)
+        ystr(con->name);
+    else
+        y(null);
+
+    if (con->type == CT_WORKSPACE) {
+        ystr("num");
+        y(integer, con->num);
+    }
+
+    ystr("window");
+    if (con->window)
+        y(integer, con->window->id);
+    else
+        y(null);
+
+    dump_rect(gen, "rect", con->rect);
+
+    y(map_close);
+}
+
+static void dump_bar_config(ipc_encoder *gen, Barconfig *config) {
     y(map_open);
 
     ystr("id");
@@ -647,27 +1086,93 @@ static void dump_bar_config(yajl_gen gen, Barconfig *config) {
 #undef YSTR_IF_SET
 }
 
+/*
+ * Returns the encoding requested by the client for the reply to the given
+ * message type (see I3_IPC_MESSAGE_FLAG_CBOR).
+ *
+ */
+static ipc_encoding_t requested_encoding(uint32_t message_type) {
+    return (message_type & I3_IPC_MESSAGE_FLAG_CBOR ? IPC_ENCODING_CBOR : IPC_ENCODING_JSON);
+}
+
+/*
+ * Returns the reply type for the given reply type and encoding: CBOR-encoded
+ * replies have I3_IPC_MESSAGE_FLAG_CBOR set.
+ *
+ */
+static uint32_t encoded_reply_type(uint32_t reply_type, ipc_encoder *gen) {
+    if (ipc_encoder_encoding(gen) == IPC_ENCODING_CBOR)
+        return reply_type | I3_IPC_MESSAGE_FLAG_CBOR;
+    return reply_type;
+}
+
+/*
+ * Formats the reply message for a GET_TREE request and sends it to the client.
+ * If the payload contains a container id (as received in events), only the
+ * subtree of that container is dumped. The reply is encoded as CBOR if the
+ * client set I3_IPC_MESSAGE_FLAG_CBOR.
+ *
+ * The whole tree is taken from a snapshot (see tree_snapshot.c), subtrees are
+ * dumped into CBOR here. Converting them to JSON and writing them to the
+ * client is done by ipc_worker_send_tree(), on a worker thread for large
+ * trees.
+ *
+ */
 IPC_HANDLER(tree) {
-    setlocale(LC_NUMERIC, "C");
-    yajl_gen gen = ygenalloc();
-    dump_node(gen, croot, false);
-    setlocale(LC_NUMERIC, "");
+    Con *con = croot;
+    bool found = true;
+    if (message_size > 0) {
+        /* To get a properly terminated buffer, we copy
+         * message_size bytes out of the buffer */
+        char *con_id = scalloc(message_size + 1);
+        strncpy(con_id, (const char *)message, message_size);
+        char *end;
+        long int parsed = strtol(con_id, &end, 10);
+        found = false;
+        if (*con_id != '\0' && *end == '\0') {
+            Con *current;
+            TAILQ_FOREACH(current, &all_cons, all_cons) {
+                if ((long int)current != parsed)
+                    continue;
+                con = current;
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            LOG("IPC: no container with id \"%s\"\n", con_id);
+        free(con_id);
+    }
 
-    const unsigned char *payload;
-    ylength length;
-    y(get_buf, &payload, &length);
+    /* The whole tree is served from a snapshot, which is reused as long as
+     * the tree does not change. */
+    if (found && con == croot) {
+        ipc_worker_send_tree(client_for_fd(fd), tree_snapshot_take(), NULL, requested_encoding(message_type));
+        return;
+    }
 
-    ipc_send_message(fd, length, I3_IPC_REPLY_TYPE_TREE, payload);
-    y(free);
+    ipc_encoder *gen = ipc_encoder_new(IPC_ENCODING_CBOR);
+    if (found)
+        dump_node(gen, con, false);
+    else {
+        /* If we did not find the requested container, the reply will contain
+         * a null 'id' field. */
+        y(map_open);
+        ystr("id");
+        y(null);
+        y(map_close);
+    }
+
+    ipc_worker_send_tree(client_for_fd(fd), NULL, gen, requested_encoding(message_type));
 }
 
 /*
  * Formats the reply message for a GET_WORKSPACES request and sends it to the
- * client
+ * client (encoded as CBOR if the client set I3_IPC_MESSAGE_FLAG_CBOR)
  *
  */
 IPC_HANDLER(get_workspaces) {
-    yajl_gen gen = ygenalloc();
+    ipc_encoder *gen = ipc_encoder_new(requested_encoding(message_type));
     y(array_open);
 
     Con *focused_ws = con_get_workspace(focused);
@@ -721,7 +1226,7 @@ IPC_HANDLER(get_workspaces) {
     ylength length;
     y(get_buf, &payload, &length);
 
-    ipc_send_message(fd, length, I3_IPC_REPLY_TYPE_WORKSPACES, payload);
+    ipc_send_message(fd, length, encoded_reply_type(I3_IPC_REPLY_TYPE_WORKSPACES, gen), payload);
     y(free);
 }
 
@@ -731,7 +1236,7 @@ IPC_HANDLER(get_workspaces) {
  *
  */
 IPC_HANDLER(get_outputs) {
-    yajl_gen gen = ygenalloc();
+    ipc_encoder *gen = ipc_encoder_new(IPC_ENCODING_JSON);
     y(array_open);
 
     Output *output;
@@ -785,7 +1290,7 @@ IPC_HANDLER(get_outputs) {
  *
  */
 IPC_HANDLER(get_marks) {
-    yajl_gen gen = ygenalloc();
+    ipc_encoder *gen = ipc_encoder_new(IPC_ENCODING_JSON);
     y(array_open);
 
     Con *con;
@@ -808,7 +1313,7 @@ IPC_HANDLER(get_marks) {
  *
  */
 IPC_HANDLER(get_version) {
-    yajl_gen gen = ygenalloc();
+    ipc_encoder *gen = ipc_encoder_new(IPC_ENCODING_JSON);
     y(map_open);
 
     ystr("major");
@@ -839,7 +1344,7 @@ IPC_HANDLER(get_version) {
  *
  */
 IPC_HANDLER(get_bar_config) {
-    yajl_gen gen = ygenalloc();
+    ipc_encoder *gen = ipc_encoder_new(IPC_ENCODING_JSON);
 
     /* If no ID was passed, we return a JSON array with all IDs */
     if (message_size == 0) {
@@ -894,6 +1399,32 @@ IPC_HANDLER(get_bar_config) {
     y(free);
 }
 
+/*
+ * Formats the reply message for a GET_STARTUP request and sends it to the
+ * client.
+ *
+ */
+IPC_HANDLER(get_startup) {
+    ipc_encoder *gen = ipc_encoder_new(IPC_ENCODING_JSON);
+
+    y(map_open);
+
+    ystr("phases");
+    timeline_dump(gen);
+
+    ystr("autostarts");
+    autostart_dump(gen);
+
+    y(map_close);
+
+    const unsigned char *payload;
+    ylength length;
+    y(get_buf, &payload, &length);
+
+    ipc_send_message(fd, length, I3_IPC_REPLY_TYPE_STARTUP, payload);
+    y(free);
+}
+
 /*
  * Callback for the YAJL parser (will be called when a string is parsed).
  *
@@ -905,27 +1436,57 @@ static int add_subscription(void *extra, const unsigned char *s,
     DLOG("should add subscription to extra %p, sub %.*s\n", client, (int)len, s);
     int event = client->num_events;
 
+    /* Clients can request the compact flavor of an event by appending
+     * ":compact" to its name, e.g. "window:compact", and every event
+     * (instead of only the last one of several redundant events emitted
+     * during one event loop iteration) by appending ":all". Both suffixes can
+     * be combined. */
+    static const char compact_suffix[] = ":compact";
+    static const char all_suffix[] = ":all";
+    bool compact = false;
+    bool all = false;
+    while (true) {
+        if (len > strlen(compact_suffix) &&
+            strncasecmp((const char *)s + len - strlen(compact_suffix), compact_suffix, strlen(compact_suffix)) == 0) {
+            compact = true;
+            len -= strlen(compact_suffix);
+        } else if (len > strlen(all_suffix) &&
+                   strncasecmp((const char *)s + len - strlen(all_suffix), all_suffix, strlen(all_suffix)) == 0) {
+            all = true;
+            len -= strlen(all_suffix);
+        } else {
+            break;
+        }
+    }
+
     client->num_events++;
     client->events = realloc(client->events, client->num_events * sizeof(char *));
+    client->compact_events = realloc(client->compact_events, client->num_events * sizeof(bool));
+    client->all_events = realloc(client->all_events, client->num_events * sizeof(bool));
     /* We copy the string because it is not null-terminated and strndup()
      * is missing on some BSD systems */
     client->events[event] = scalloc(len + 1);
     memcpy(client->events[event], s, len);
+    client->compact_events[event] = compact;
+    client->all_events[event] = all;
 
     DLOG("client is now subscribed to:\n");
     for (int i = 0; i < client->num_events; i++)
-        DLOG("event %s\n", client->events[i]);
+        DLOG("event %s%s%s\n", client->events[i],
+             (client->compact_events[i] ? " (compact)" : ""),
+             (client->all_events[i] ? " (all)" : ""));
     DLOG("(done)\n");
 
     return 1;
 }
 
 /*
- * Subscribes this connection to the event types which were given as a JSON
- * serialized array in the payload field of the message.
+ * Subscribes the client of the given connection to the event types which were
+ * given as a JSON serialized array. Returns the client, or NULL if the
+ * payload could not be parsed.
  *
  */
-IPC_HANDLER(subscribe) {
+static ipc_client *subscribe_client(int fd, const uint8_t *message, uint32_t message_size) {
     yajl_handle p;
     yajl_status stat;
     ipc_client *current, *client = NULL;
@@ -941,7 +1502,7 @@ IPC_HANDLER(subscribe) {
 
     if (client == NULL) {
         ELOG("Could not find ipc_client data structure for fd %d\n", fd);
-        return;
+        return NULL;
     }
 
     /* Setup the JSON parser */
@@ -957,20 +1518,69 @@ IPC_HANDLER(subscribe) {
                              message_size);
         ELOG("YAJL parse error: %s\n", err);
         yajl_free_error(p, err);
-
-        const char *reply = "{\"success\":false}";
-        ipc_send_message(fd, strlen(reply), I3_IPC_REPLY_TYPE_SUBSCRIBE, (const uint8_t *)reply);
         yajl_free(p);
-        return;
+        return NULL;
     }
     yajl_free(p);
-    const char *reply = "{\"success\":true}";
+    return client;
+}
+
+/*
+ * Subscribes this connection to the event types which were given as a JSON
+ * serialized array in the payload field of the message.
+ *
+ */
+IPC_HANDLER(subscribe) {
+    const char *reply = "{\"success\":false}";
+    if (subscribe_client(fd, message, message_size) != NULL)
+        reply = "{\"success\":true}";
     ipc_send_message(fd, strlen(reply), I3_IPC_REPLY_TYPE_SUBSCRIBE, (const uint8_t *)reply);
 }
 
+/*
+ * Like SUBSCRIBE, but the events are written to a shared memory ring buffer.
+ * The reply contains the name of the shared memory object, which the client
+ * maps to read the events. The socket only carries wakeups
+ * (I3_IPC_EVENT_RING_WAKEUP) from then on.
+ *
+ */
+IPC_HANDLER(subscribe_ring) {
+    ipc_client *client = subscribe_client(fd, message, message_size);
+    if (client != NULL && client->ring == NULL)
+        client->ring = ipc_ring_new();
+
+    if (client == NULL || client->ring == NULL) {
+        const char *reply = "{\"success\":false}";
+        ipc_send_message(fd, strlen(reply), I3_IPC_REPLY_TYPE_SUBSCRIBE_RING, (const uint8_t *)reply);
+        return;
+    }
+
+    ipc_encoder *gen = ipc_encoder_new(IPC_ENCODING_JSON);
+
+    y(map_open);
+
+    ystr("success");
+    y(bool, true);
+
+    ystr("name");
+    ystr(ipc_ring_name(client->ring));
+
+    ystr("size");
+    y(integer, ipc_ring_size(client->ring));
+
+    y(map_close);
+
+    const unsigned char *payload;
+    ylength length;
+    y(get_buf, &payload, &length);
+
+    ipc_send_message(fd, length, I3_IPC_REPLY_TYPE_SUBSCRIBE_RING, payload);
+    y(free);
+}
+
 /* The index of each callback function corresponds to the numeric
  * value of the message type (see include/i3/ipc.h) */
-handler_t handlers[8] = {
+handler_t handlers[10] = {
     handle_command,
     handle_get_workspaces,
     handle_subscribe,
@@ -979,6 +1589,8 @@ handler_t handlers[8] = {
     handle_get_marks,
     handle_get_bar_config,
     handle_get_version,
+    handle_get_startup,
+    handle_subscribe_ring,
 };
 
 /*
@@ -1007,35 +1619,18 @@ static void ipc_receive_message(EV_P_ struct ev_io *w, int revents) {
 
         /* If not, there was some kind of error. We don’t bother
          * and close the connection */
-        close(w->fd);
-
-        /* Delete the client from the list of clients */
-        ipc_client *current;
-        TAILQ_FOREACH(current, &all_clients, clients) {
-            if (current->fd != w->fd)
-                continue;
-
-            for (int i = 0; i < current->num_events; i++)
-                free(current->events[i]);
-            /* We can call TAILQ_REMOVE because we break out of the
-             * TAILQ_FOREACH afterwards */
-            TAILQ_REMOVE(&all_clients, current, clients);
-            free(current);
-            break;
-        }
-
-        ev_io_stop(EV_A_ w);
-        free(w);
+        ipc_client_disconnect(client_for_fd(w->fd));
         FREE(message);
-
-        DLOG("IPC: client disconnected\n");
         return;
     }
 
-    if (message_type >= (sizeof(handlers) / sizeof(handler_t)))
+    /* The encoding flag is passed on to the handler as part of the message
+     * type, handlers which do not support CBOR ignore it. */
+    const uint32_t handler_index = (message_type & ~I3_IPC_MESSAGE_FLAG_CBOR);
+    if (handler_index >= (sizeof(handlers) / sizeof(handler_t)))
         DLOG("Unhandled message type: %d\n", message_type);
     else {
-        handler_t h = handlers[message_type];
+        handler_t h = handlers[handler_index];
         h(w->fd, message, 0, message_length, message_type);
     }
 
@@ -1074,6 +1669,7 @@ void ipc_new_client(EV_P_ struct ev_io *w, int revents) {
 
     ipc_client *new = scalloc(sizeof(ipc_client));
     new->fd = client;
+    new->callback = package;
 
     TAILQ_INSERT_TAIL(&all_clients, new, clients);
 }
@@ -1130,12 +1726,13 @@ int ipc_create_socket(const char *filename) {
 }
 
 /*
- * Generates a json workspace event. Returns a dynamically allocated yajl
- * generator. Free with yajl_gen_free().
+ * Generates a json workspace event, see ipc_marshal_workspace_event(). When
+ * old is NULL, old_json (a serialized container) is used instead, if given.
+ *
  */
-yajl_gen ipc_marshal_workspace_event(const char *change, Con *current, Con *old) {
+static ipc_encoder *marshal_workspace_event(const char *change, Con *current, Con *old, const char *old_json, bool compact) {
     setlocale(LC_NUMERIC, "C");
-    yajl_gen gen = ygenalloc();
+    ipc_encoder *gen = ipc_encoder_new(IPC_ENCODING_JSON);
 
     y(map_open);
 
@@ -1145,14 +1742,24 @@ yajl_gen ipc_marshal_workspace_event(const char *change, Con *current, Con *old)
     ystr("current");
     if (current == NULL)
         y(null);
+    else if (compact)
+        dump_node_compact(gen, current);
     else
         dump_node(gen, current, false);
 
     ystr("old");
-    if (old == NULL)
+    if (old != NULL) {
+        if (compact)
+            dump_node_compact(gen, old);
+        else
+            dump_node(gen, old, false);
+    } else if (old_json != NULL) {
+        /* For JSON, ipc_encoder_number() inserts its argument verbatim,
+         * which is the only way to embed an already serialized value. */
+        y(number, old_json, strlen(old_json));
+    } else {
         y(null);
-    else
-        dump_node(gen, old, false);
+    }
 
     y(map_close);
 
@@ -1161,33 +1768,42 @@ yajl_gen ipc_marshal_workspace_event(const char *change, Con *current, Con *old)
     return gen;
 }
 
+/*
+ * Generates a json workspace event. Returns a dynamically allocated JSON
+ * encoder. Free with ipc_encoder_free().
+ *
+ * When compact is true, the workspaces are not serialized with dump_node(),
+ * only their id, name, num and rect are included.
+ */
+ipc_encoder *ipc_marshal_workspace_event(const char *change, Con *current, Con *old, bool compact) {
+    return marshal_workspace_event(change, current, old, NULL, compact);
+}
+
 /*
  * For the workspace events we send, along with the usual "change" field, also
  * the workspace container in "current". For focus events, we send the
  * previously focused workspace in "old".
+ *
+ * The event is queued and serialized when it is sent, see ipc_flush_events().
  */
 void ipc_send_workspace_event(const char *change, Con *current, Con *old) {
-    yajl_gen gen = ipc_marshal_workspace_event(change, current, old);
-
-    const unsigned char *payload;
-    ylength length;
-    y(get_buf, &payload, &length);
-
-    ipc_send_event("workspace", I3_IPC_EVENT_WORKSPACE, (const char *)payload);
+    ipc_pending_event *pending = queue_event("workspace", I3_IPC_EVENT_WORKSPACE, change);
+    if (pending == NULL)
+        return;
 
-    y(free);
+    pending->marshal = true;
+    pending->con = current;
+    pending->old = pending->first_old = old;
+    coalesce_event(pending);
 }
 
-/**
- * For the window events we send, along the usual "change" field,
- * also the window container, in "container".
+/*
+ * Generates a json window event, see ipc_send_window_event().
+ *
  */
-void ipc_send_window_event(const char *property, Con *con) {
-    DLOG("Issue IPC window %s event (con = %p, window = 0x%08x)\n",
-         property, con, (con->window ? con->window->id : XCB_WINDOW_NONE));
-
+static ipc_encoder *marshal_window_event(const char *property, Con *con, bool compact) {
     setlocale(LC_NUMERIC, "C");
-    yajl_gen gen = ygenalloc();
+    ipc_encoder *gen = ipc_encoder_new(IPC_ENCODING_JSON);
 
     y(map_open);
 
@@ -1195,17 +1811,35 @@ void ipc_send_window_event(const char *property, Con *con) {
     ystr(property);
 
     ystr("container");
-    dump_node(gen, con, false);
+    if (compact)
+        dump_node_compact(gen, con);
+    else
+        dump_node(gen, con, false);
 
     y(map_close);
 
-    const unsigned char *payload;
-    ylength length;
-    y(get_buf, &payload, &length);
-
-    ipc_send_event("window", I3_IPC_EVENT_WINDOW, (const char *)payload);
-    y(free);
     setlocale(LC_NUMERIC, "");
+
+    return gen;
+}
+
+/**
+ * For the window events we send, along the usual "change" field,
+ * also the window container, in "container".
+ *
+ * The event is queued and serialized when it is sent, see ipc_flush_events().
+ */
+void ipc_send_window_event(const char *property, Con *con) {
+    DLOG("Issue IPC window %s event (con = %p, window = 0x%08x)\n",
+         property, con, (con->window ? con->window->id : XCB_WINDOW_NONE));
+
+    ipc_pending_event *pending = queue_event("window", I3_IPC_EVENT_WINDOW, property);
+    if (pending == NULL)
+        return;
+
+    pending->marshal = true;
+    pending->con = con;
+    coalesce_event(pending);
 }
 
 /**
@@ -1214,7 +1848,7 @@ void ipc_send_window_event(const char *property, Con *con) {
 void ipc_send_barconfig_update_event(Barconfig *barconfig) {
     DLOG("Issue barconfig_update event for id = %s\n", barconfig->id);
     setlocale(LC_NUMERIC, "C");
-    yajl_gen gen = ygenalloc();
+    ipc_encoder *gen = ipc_encoder_new(IPC_ENCODING_JSON);
 
     dump_bar_config(gen, barconfig);
 
@@ -1235,7 +1869,7 @@ void ipc_send_binding_event(const char *event_type, Binding *bind) {
 
     setlocale(LC_NUMERIC, "C");
 
-    yajl_gen gen = ygenalloc();
+    ipc_encoder *gen = ipc_encoder_new(IPC_ENCODING_JSON);
 
     y(map_open);
 
@@ -0,0 +1,316 @@
+#undef I3__FILE__
+#define I3__FILE__ "ipc_encoder.c"
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * ipc_encoder.c: Generates IPC payloads either as JSON (using yajl) or as
+ *                CBOR, so that the same dump functions serve both encodings.
+ *
+ */
+#include "all.h"
+
+/* CBOR major types (RFC 7049, section 2.1) */
+#define CBOR_UNSIGNED 0
+#define CBOR_NEGATIVE 1
+#define CBOR_TEXT 3
+
+/* Initial bytes of items which do not carry an argument */
+#define CBOR_ARRAY_INDEFINITE 0x9f
+#define CBOR_MAP_INDEFINITE 0xbf
+#define CBOR_FALSE 0xf4
+#define CBOR_TRUE 0xf5
+#define CBOR_NULL 0xf6
+#define CBOR_DOUBLE 0xfb
+#define CBOR_BREAK 0xff
+
+struct ipc_encoder {
+    ipc_encoding_t encoding;
+
+    /* Used for IPC_ENCODING_JSON */
+    yajl_gen json;
+
+    /* Used for IPC_ENCODING_CBOR */
+    unsigned char *buf;
+    size_t length;
+    size_t capacity;
+};
+
+/*
+ * Creates a new encoder which generates the given encoding.
+ *
+ */
+ipc_encoder *ipc_encoder_new(ipc_encoding_t encoding) {
+    ipc_encoder *encoder = scalloc(sizeof(ipc_encoder));
+    encoder->encoding = encoding;
+    if (encoding == IPC_ENCODING_JSON)
+        encoder->json = yajl_gen_alloc(NULL);
+    return encoder;
+}
+
+/*
+ * Returns the encoding which the given encoder generates.
+ *
+ */
+ipc_encoding_t ipc_encoder_encoding(ipc_encoder *encoder) {
+    return encoder->encoding;
+}
+
+/*
+ * Makes room for the given number of bytes at the end of the CBOR buffer and
+ * returns a pointer to them.
+ *
+ */
+static unsigned char *cbor_reserve(ipc_encoder *encoder, size_t length) {
+    if (encoder->length + length > encoder->capacity) {
+        /* Dumping the tree generates many small items, so grow
+         * exponentially. */
+        while (encoder->length + length > encoder->capacity)
+            encoder->capacity = (encoder->capacity == 0 ? 4096 : encoder->capacity * 2);
+        encoder->buf = srealloc(encoder->buf, encoder->capacity);
+    }
+    unsigned char *dest = encoder->buf + encoder->length;
+    encoder->length += length;
+    return dest;
+}
+
+static void cbor_byte(ipc_encoder *encoder, unsigned char byte) {
+    *cbor_reserve(encoder, 1) = byte;
+}
+
+/*
+ * Appends the given value in network byte order, using the given number of
+ * bytes.
+ *
+ */
+static void cbor_big_endian(ipc_encoder *encoder, uint64_t value, int bytes) {
+    unsigned char *dest = cbor_reserve(encoder, bytes);
+    for (int i = bytes - 1; i >= 0; i--) {
+        dest[i] = value & 0xff;
+        value >>= 8;
+    }
+}
+
+/*
+ * Appends the initial byte of an item of the given major type together with
+ * its argument (the value of an integer, the length of a string, …), using
+ * the shortest possible form.
+ *
+ */
+static void cbor_head(ipc_encoder *encoder, int major, uint64_t argument) {
+    const unsigned char type = major << 5;
+    if (argument < 24) {
+        cbor_byte(encoder, type | argument);
+    } else if (argument <= UINT8_MAX) {
+        cbor_byte(encoder, type | 24);
+        cbor_big_endian(encoder, argument, 1);
+    } else if (argument <= UINT16_MAX) {
+        cbor_byte(encoder, type | 25);
+        cbor_big_endian(encoder, argument, 2);
+    } else if (argument <= UINT32_MAX) {
+        cbor_byte(encoder, type | 26);
+        cbor_big_endian(encoder, argument, 4);
+    } else {
+        cbor_byte(encoder, type | 27);
+        cbor_big_endian(encoder, argument, 8);
+    }
+}
+
+/* Maps and arrays are encoded with indefinite length, because the number of
+ * their entries is not known when they are opened. */
+void ipc_encoder_map_open(ipc_encoder *encoder) {
+    if (encoder->encoding == IPC_ENCODING_JSON)
+        yajl_gen_map_open(encoder->json);
+    else
+        cbor_byte(encoder, CBOR_MAP_INDEFINITE);
+}
+
+void ipc_encoder_map_close(ipc_encoder *encoder) {
+    if (encoder->encoding == IPC_ENCODING_JSON)
+        yajl_gen_map_close(encoder->json);
+    else
+        cbor_byte(encoder, CBOR_BREAK);
+}
+
+void ipc_encoder_array_open(ipc_encoder *encoder) {
+    if (encoder->encoding == IPC_ENCODING_JSON)
+        yajl_gen_array_open(encoder->json);
+    else
+        cbor_byte(encoder, CBOR_ARRAY_INDEFINITE);
+}
+
+void ipc_encoder_array_close(ipc_encoder *encoder) {
+    if (encoder->encoding == IPC_ENCODING_JSON)
+        yajl_gen_array_close(encoder->json);
+    else
+        cbor_byte(encoder, CBOR_BREAK);
+}
+
+void ipc_encoder_null(ipc_encoder *encoder) {
+    if (encoder->encoding == IPC_ENCODING_JSON)
+        yajl_gen_null(encoder->json);
+    else
+        cbor_byte(encoder, CBOR_NULL);
+}
+
+void ipc_encoder_bool(ipc_encoder *encoder, bool value) {
+    if (encoder->encoding == IPC_ENCODING_JSON)
+        yajl_gen_bool(encoder->json, value);
+    else
+        cbor_byte(encoder, value ? CBOR_TRUE : CBOR_FALSE);
+}
+
+void ipc_encoder_integer(ipc_encoder *encoder, long long value) {
+    if (encoder->encoding == IPC_ENCODING_JSON)
+        yajl_gen_integer(encoder->json, value);
+    else if (value >= 0)
+        cbor_head(encoder, CBOR_UNSIGNED, value);
+    else
+        cbor_head(encoder, CBOR_NEGATIVE, -1 - value);
+}
+
+void ipc_encoder_double(ipc_encoder *encoder, double value) {
+    if (encoder->encoding == IPC_ENCODING_JSON) {
+        yajl_gen_double(encoder->json, value);
+        return;
+    }
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    cbor_byte(encoder, CBOR_DOUBLE);
+    cbor_big_endian(encoder, bits, 8);
+}
+
+void ipc_encoder_string(ipc_encoder *encoder, const unsigned char *str, size_t length) {
+    if (encoder->encoding == IPC_ENCODING_JSON) {
+        yajl_gen_string(encoder->json, str, length);
+        return;
+    }
+
+    cbor_head(encoder, CBOR_TEXT, length);
+    memcpy(cbor_reserve(encoder, length), str, length);
+}
+
+/*
+ * Inserts the given number verbatim (for JSON). For CBOR, it is parsed and
+ * encoded as an integer or a double.
+ *
+ */
+void ipc_encoder_number(ipc_encoder *encoder, const char *number, size_t length) {
+    if (encoder->encoding == IPC_ENCODING_JSON) {
+        yajl_gen_number(encoder->json, number, length);
+        return;
+    }
+
+    char *copy = scalloc(length + 1);
+    memcpy(copy, number, length);
+    if (strpbrk(copy, ".eE") != NULL)
+        ipc_encoder_double(encoder, strtod(copy, NULL));
+    else
+        ipc_encoder_integer(encoder, strtoll(copy, NULL, 10));
+    free(copy);
+}
+
+/*
+ * Callbacks for cbor_parse() which pass each item on to an encoder.
+ *
+ */
+static int cbor_null_cb(void *encoder) {
+    ipc_encoder_null(encoder);
+    return 1;
+}
+
+static int cbor_boolean_cb(void *encoder, int value) {
+    ipc_encoder_bool(encoder, value);
+    return 1;
+}
+
+static int cbor_integer_cb(void *encoder, long long value) {
+    ipc_encoder_integer(encoder, value);
+    return 1;
+}
+
+static int cbor_double_cb(void *encoder, double value) {
+    ipc_encoder_double(encoder, value);
+    return 1;
+}
+
+static int cbor_string_cb(void *encoder, const unsigned char *value, size_t length) {
+    ipc_encoder_string(encoder, value, length);
+    return 1;
+}
+
+static int cbor_start_map_cb(void *encoder) {
+    ipc_encoder_map_open(encoder);
+    return 1;
+}
+
+static int cbor_end_map_cb(void *encoder) {
+    ipc_encoder_map_close(encoder);
+    return 1;
+}
+
+static int cbor_start_array_cb(void *encoder) {
+    ipc_encoder_array_open(encoder);
+    return 1;
+}
+
+static int cbor_end_array_cb(void *encoder) {
+    ipc_encoder_array_close(encoder);
+    return 1;
+}
+
+static cbor_callbacks cbor_to_encoder_callbacks = {
+    .cbor_null = cbor_null_cb,
+    .cbor_boolean = cbor_boolean_cb,
+    .cbor_integer = cbor_integer_cb,
+    .cbor_double = cbor_double_cb,
+    .cbor_string = cbor_string_cb,
+    .cbor_start_map = cbor_start_map_cb,
+    .cbor_map_key = cbor_string_cb,
+    .cbor_end_map = cbor_end_map_cb,
+    .cbor_start_array = cbor_start_array_cb,
+    .cbor_end_array = cbor_end_array_cb,
+};
+
+/*
+ * Appends the item contained in the given CBOR data (e.g. a snapshot of the
+ * tree) to the encoder, converting it to JSON if necessary. Returns false if
+ * the data is malformed.
+ *
+ */
+bool ipc_encoder_append_cbor(ipc_encoder *encoder, const unsigned char *data, size_t length) {
+    if (encoder->encoding == IPC_ENCODING_CBOR) {
+        memcpy(cbor_reserve(encoder, length), data, length);
+        return true;
+    }
+
+    return cbor_parse(data, length, &cbor_to_encoder_callbacks, encoder);
+}
+
+/*
+ * Returns the generated payload. It remains valid until the encoder is freed.
+ *
+ */
+void ipc_encoder_get_buf(ipc_encoder *encoder, const unsigned char **buf, size_t *length) {
+    if (encoder->encoding == IPC_ENCODING_JSON) {
+        yajl_gen_get_buf(encoder->json, buf, length);
+        return;
+    }
+
+    *buf = encoder->buf;
+    *length = encoder->length;
+}
+
+/*
+ * Frees the encoder and its payload.
+ *
+ */
+void ipc_encoder_free(ipc_encoder *encoder) {
+    if (encoder->json != NULL)
+        yajl_gen_free(encoder->json);
+    free(encoder->buf);
+    free(encoder);
+}
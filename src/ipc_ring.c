@@ -0,0 +1,193 @@
+#undef I3__FILE__
+#define I3__FILE__ "ipc_ring.c"
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * ipc_ring.c: Shared memory ring buffers through which IPC events are
+ *             delivered to clients which subscribed with SUBSCRIBE_RING.
+ *
+ */
+#include "all.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Size of the data area of each ring. Events are flushed at least once per
+ * event loop iteration, so this only needs to hold the events of a few
+ * iterations. */
+#define IPC_RING_SIZE (256 * 1024)
+
+/* Records are padded to a multiple of this. */
+#define IPC_RING_ALIGN 8
+
+struct ipc_ring {
+    char *name;
+    int fd;
+    i3_ipc_ring_header_t *header;
+    char *data;
+
+    /* The authoritative write offset. It is only published to the header,
+     * which the client could modify. */
+    uint64_t write_offset;
+
+    /* The write_offset at the beginning of the current batch (see
+     * ipc_ring_end_batch()), or UINT64_MAX if nothing was written since. */
+    uint64_t batch_start;
+};
+
+/* Counter for unique names of the shared memory objects. */
+static int num_rings;
+
+/*
+ * Creates a new ring buffer in a POSIX shared memory object. Returns NULL if
+ * that failed.
+ *
+ */
+ipc_ring *ipc_ring_new(void) {
+    ipc_ring *ring = scalloc(sizeof(ipc_ring));
+#if defined(__FreeBSD__)
+    sasprintf(&(ring->name), "/tmp/i3-ipc-ring-%d-%d", getpid(), num_rings++);
+#else
+    sasprintf(&(ring->name), "/i3-ipc-ring-%d-%d", getpid(), num_rings++);
+#endif
+    ring->batch_start = UINT64_MAX;
+
+    const size_t length = sizeof(i3_ipc_ring_header_t) + IPC_RING_SIZE;
+    ring->fd = shm_open(ring->name, O_RDWR | O_CREAT | O_EXCL, S_IREAD | S_IWRITE);
+    if (ring->fd == -1) {
+        ELOG("Could not shm_open SHM segment %s for an IPC ring: %s\n", ring->name, strerror(errno));
+        free(ring->name);
+        free(ring);
+        return NULL;
+    }
+
+    if (ftruncate(ring->fd, length) == -1) {
+        ELOG("Could not ftruncate SHM segment %s for an IPC ring: %s\n", ring->name, strerror(errno));
+        ipc_ring_free(ring);
+        return NULL;
+    }
+
+    void *mapping = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, 0);
+    if (mapping == MAP_FAILED) {
+        ELOG("Could not mmap SHM segment %s for an IPC ring: %s\n", ring->name, strerror(errno));
+        ipc_ring_free(ring);
+        return NULL;
+    }
+
+    ring->header = mapping;
+    ring->data = (char *)mapping + sizeof(i3_ipc_ring_header_t);
+    memset(ring->header, '\0', sizeof(i3_ipc_ring_header_t));
+    memcpy(ring->header->magic, I3_IPC_RING_MAGIC, sizeof(ring->header->magic));
+    ring->header->size = IPC_RING_SIZE;
+
+    DLOG("Created IPC ring %s\n", ring->name);
+    return ring;
+}
+
+/*
+ * Returns the name of the shared memory object of the given ring (to be
+ * opened by the client with shm_open()).
+ *
+ */
+const char *ipc_ring_name(ipc_ring *ring) {
+    return ring->name;
+}
+
+/*
+ * Returns the size of the data area of the given ring.
+ *
+ */
+uint32_t ipc_ring_size(ipc_ring *ring) {
+    return IPC_RING_SIZE;
+}
+
+/*
+ * Appends an event to the ring. If the client did not consume enough of the
+ * previous events to make room for it, the event is dropped (and counted in
+ * the header). Returns whether the event was written.
+ *
+ */
+bool ipc_ring_write(ipc_ring *ring, uint32_t type, const char *payload, uint32_t size) {
+    i3_ipc_ring_header_t *header = ring->header;
+    const uint64_t needed = (sizeof(i3_ipc_ring_record_t) + size + IPC_RING_ALIGN - 1) & ~(uint64_t)(IPC_RING_ALIGN - 1);
+
+    /* The client modifies read_offset concurrently. A misbehaving client
+     * must not make us write outside of the data area, so the write offset is
+     * never read back from the shared header, and read_offset is only used
+     * for the free space. Since the write offset is always aligned, padding
+     * records fit before the end of the data area. */
+    uint64_t write = ring->write_offset;
+    uint64_t read = __atomic_load_n(&(header->read_offset), __ATOMIC_SEQ_CST);
+    if (read > write)
+        read = write;
+
+    /* Records are not split: if the record does not fit before the end of the
+     * data area, the rest is skipped using a padding record. */
+    const uint64_t position = write % IPC_RING_SIZE;
+    const uint64_t to_end = IPC_RING_SIZE - position;
+    const uint64_t padding = (to_end < needed ? to_end : 0);
+
+    if (write - read + padding + needed > IPC_RING_SIZE) {
+        __atomic_add_fetch(&(header->dropped), 1, __ATOMIC_SEQ_CST);
+        DLOG("IPC ring %s is full, dropping event (type 0x%08x)\n", ring->name, type);
+        return false;
+    }
+
+    if (ring->batch_start == UINT64_MAX)
+        ring->batch_start = write;
+
+    if (padding > 0) {
+        i3_ipc_ring_record_t *record = (i3_ipc_ring_record_t *)(ring->data + position);
+        record->type = 0;
+        record->size = padding - sizeof(i3_ipc_ring_record_t);
+        write += padding;
+    }
+
+    i3_ipc_ring_record_t *record = (i3_ipc_ring_record_t *)(ring->data + (write % IPC_RING_SIZE));
+    record->type = type;
+    record->size = size;
+    memcpy(record + 1, payload, size);
+    write += needed;
+    ring->write_offset = write;
+
+    /* Publish the record only after it was written completely. */
+    __atomic_store_n(&(header->write_offset), write, __ATOMIC_SEQ_CST);
+    return true;
+}
+
+/*
+ * Ends a batch of ipc_ring_write() calls. Returns true if events were written
+ * and the client had consumed all events before them, i.e. it might be
+ * waiting for a wakeup on the socket.
+ *
+ */
+bool ipc_ring_end_batch(ipc_ring *ring) {
+    if (ring->batch_start == UINT64_MAX)
+        return false;
+
+    /* The client stores its read_offset before checking write_offset again
+     * and we store write_offset (in ipc_ring_write()) before loading
+     * read_offset, so at least one of us sees the update of the other. */
+    const uint64_t read = __atomic_load_n(&(ring->header->read_offset), __ATOMIC_SEQ_CST);
+    const bool wakeup = (read >= ring->batch_start);
+    ring->batch_start = UINT64_MAX;
+    return wakeup;
+}
+
+/*
+ * Unmaps and unlinks the ring buffer and frees it.
+ *
+ */
+void ipc_ring_free(ipc_ring *ring) {
+    if (ring->header != NULL)
+        munmap(ring->header, sizeof(i3_ipc_ring_header_t) + IPC_RING_SIZE);
+    close(ring->fd);
+    shm_unlink(ring->name);
+    DLOG("Removed IPC ring %s\n", ring->name);
+    free(ring->name);
+    free(ring);
+}
@@ -0,0 +1,254 @@
+#undef I3__FILE__
+#define I3__FILE__ "ipc_worker.c"
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * ipc_worker.c: Converts GET_TREE replies to JSON and writes them to the
+ *               client on worker threads, so that large trees do not block
+ *               the event loop.
+ *
+ * The main thread dumps the tree into CBOR (see ipc_encoder.c and
+ * tree_snapshot.c), which is much cheaper than generating JSON: there is no
+ * escaping and no formatting of numbers. The dump is immutable, so the worker
+ * thread does not need to access any of i3’s data structures. It must not call any i3
+ * functions which are not thread-safe (e.g. LOG).
+ *
+ */
+#include "all.h"
+
+#include <locale.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+
+/* Snapshots smaller than this are converted and sent right away, starting a
+ * thread would take longer than that. */
+#define IPC_WORKER_THRESHOLD (64 * 1024)
+
+/* Clients which do not read from their socket for this long (in ms) are
+ * disconnected, so that they cannot hold a worker thread forever. */
+#define IPC_WORKER_WRITE_TIMEOUT 5000
+
+struct tree_job {
+    ipc_client *client;
+    int fd;
+    /* One of them holds the CBOR-encoded tree, see ipc_worker_send_tree(). */
+    tree_snapshot *snapshot;
+    ipc_encoder *dump;
+    const unsigned char *payload;
+    size_t length;
+    ipc_encoding_t encoding;
+    double started;
+
+    pthread_t thread;
+    /* Set by the worker thread once the reply was written. */
+    bool done;
+    /* Whether the reply could not be written completely, in which case the
+     * client is disconnected. */
+    bool failed;
+
+    TAILQ_ENTRY(tree_job) jobs;
+};
+
+static TAILQ_HEAD(jobs_head, tree_job) jobs = TAILQ_HEAD_INITIALIZER(jobs);
+
+/* Signalled by the worker threads when they are done. */
+static struct ev_async *jobs_done;
+
+/*
+ * Writes the whole buffer to the (non-blocking) client socket, waiting for
+ * the client to read whenever the socket buffer is full. Returns false on
+ * errors, e.g. when the client disconnected, or when the client did not read
+ * for IPC_WORKER_WRITE_TIMEOUT ms.
+ *
+ */
+static bool write_blocking(int fd, const void *buf, size_t count) {
+    const char *pos = buf;
+    while (count > 0) {
+        ssize_t n = write(fd, pos, count);
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN)
+                return false;
+
+            struct pollfd pollfd = {.fd = fd, .events = POLLOUT};
+            const int ready = poll(&pollfd, 1, IPC_WORKER_WRITE_TIMEOUT);
+            if (ready == 0 || (ready == -1 && errno != EINTR))
+                return false;
+            continue;
+        }
+        pos += n;
+        count -= n;
+    }
+    return true;
+}
+
+/*
+ * Converts the snapshot of the given job (if necessary) and writes the reply
+ * to the client. Runs on the worker thread (or on the main thread for small
+ * snapshots).
+ *
+ */
+static void run_job(struct tree_job *job) {
+    const unsigned char *payload = job->payload;
+    size_t length = job->length;
+
+    uint32_t reply_type = I3_IPC_REPLY_TYPE_TREE;
+    ipc_encoder *gen = NULL;
+    if (job->encoding == IPC_ENCODING_CBOR) {
+        reply_type |= I3_IPC_MESSAGE_FLAG_CBOR;
+    } else {
+        /* yajl formats doubles according to LC_NUMERIC, which the main
+         * thread changes at will. A thread-local locale is not affected. */
+        locale_t c_locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+        locale_t previous = (c_locale != (locale_t)0 ? uselocale(c_locale) : (locale_t)0);
+
+        gen = ipc_encoder_new(IPC_ENCODING_JSON);
+        ipc_encoder_append_cbor(gen, payload, length);
+        ipc_encoder_get_buf(gen, &payload, &length);
+
+        if (c_locale != (locale_t)0) {
+            uselocale(previous);
+            freelocale(c_locale);
+        }
+    }
+
+    const i3_ipc_header_t header = {
+        .magic = {'i', '3', '-', 'i', 'p', 'c'},
+        .size = length,
+        .type = reply_type};
+    job->failed = !(write_blocking(job->fd, &header, sizeof(header)) &&
+                    write_blocking(job->fd, payload, length));
+
+    if (gen != NULL)
+        ipc_encoder_free(gen);
+}
+
+static void *tree_job_thread(void *arg) {
+    struct tree_job *job = arg;
+
+    /* Signals are handled by the main thread. */
+    sigset_t signals;
+    sigfillset(&signals);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+    run_job(job);
+
+    __atomic_store_n(&(job->done), true, __ATOMIC_RELEASE);
+    ev_async_send(main_loop, jobs_done);
+    return NULL;
+}
+
+static void free_job(struct tree_job *job) {
+    if (job->snapshot != NULL)
+        tree_snapshot_unref(job->snapshot);
+    if (job->dump != NULL)
+        ipc_encoder_free(job->dump);
+    free(job);
+}
+
+/*
+ * Lets the client of the given job continue after the reply was written, or
+ * disconnects it if the reply could not be written, then frees the job. A
+ * partially written reply would corrupt the stream of messages anyway.
+ *
+ */
+static void finish_job(struct tree_job *job) {
+    if (job->failed) {
+        ELOG("Could not send the GET_TREE reply to fd %d, disconnecting the client.\n", job->fd);
+        ipc_client_disconnect(job->client);
+    } else if (job->client->reply_pending) {
+        ipc_client_resume(job->client);
+    }
+    free_job(job);
+}
+
+/*
+ * Called on the main thread when a worker thread is done. Lets the clients
+ * of all finished jobs continue.
+ *
+ */
+static void jobs_done_cb(EV_P_ ev_async *w, int revents) {
+    struct tree_job *job = TAILQ_FIRST(&jobs);
+    while (job != TAILQ_END(&jobs)) {
+        struct tree_job *next = TAILQ_NEXT(job, jobs);
+        if (__atomic_load_n(&(job->done), __ATOMIC_ACQUIRE)) {
+            pthread_join(job->thread, NULL);
+            TAILQ_REMOVE(&jobs, job, jobs);
+            DLOG("GET_TREE reply to fd %d sent by a worker thread after %.1f ms\n",
+                 job->fd, (ev_time() - job->started) * 1000);
+            finish_job(job);
+        }
+        job = next;
+    }
+}
+
+/*
+ * Sends the GET_TREE reply to the given client. The CBOR-encoded tree is
+ * taken either from snapshot or (for subtrees) from dump, the other one is
+ * NULL. It is converted to JSON unless the client requested CBOR. Large
+ * replies are converted and written on a worker thread, during which no
+ * further messages are read from the client. Takes ownership of the snapshot
+ * reference or the dump.
+ *
+ */
+void ipc_worker_send_tree(ipc_client *client, tree_snapshot *snapshot, ipc_encoder *dump,
+                          ipc_encoding_t encoding) {
+    struct tree_job *job = scalloc(sizeof(struct tree_job));
+    job->client = client;
+    job->fd = client->fd;
+    job->snapshot = snapshot;
+    job->dump = dump;
+    job->encoding = encoding;
+    job->started = ev_time();
+
+    if (snapshot != NULL)
+        tree_snapshot_get_layout(snapshot, &(job->payload), &(job->length));
+    else
+        ipc_encoder_get_buf(dump, &(job->payload), &(job->length));
+    if (job->length < IPC_WORKER_THRESHOLD) {
+        run_job(job);
+        finish_job(job);
+        return;
+    }
+
+    if (jobs_done == NULL) {
+        jobs_done = scalloc(sizeof(struct ev_async));
+        ev_async_init(jobs_done, jobs_done_cb);
+        ev_async_start(main_loop, jobs_done);
+    }
+
+    /* Until the reply is written, events for this client are queued and no
+     * further requests are read, so that the client receives everything in
+     * the right order. */
+    client->reply_pending = true;
+    ev_io_stop(main_loop, client->callback);
+
+    if (pthread_create(&(job->thread), NULL, tree_job_thread, job) != 0) {
+        ELOG("Could not start a worker thread, sending the GET_TREE reply directly.\n");
+        run_job(job);
+        finish_job(job);
+        return;
+    }
+
+    DLOG("Sending GET_TREE reply (%zu bytes of CBOR) to fd %d on a worker thread\n", job->length, job->fd);
+    TAILQ_INSERT_TAIL(&jobs, job, jobs);
+}
+
+/*
+ * Waits for all worker threads. Called by ipc_shutdown() after shutting down
+ * the client sockets.
+ *
+ */
+void ipc_worker_shutdown(void) {
+    struct tree_job *job;
+    while ((job = TAILQ_FIRST(&jobs)) != NULL) {
+        pthread_join(job->thread, NULL);
+        TAILQ_REMOVE(&jobs, job, jobs);
+        free_job(job);
+    }
+}
@@ -13,8 +13,9 @@
 
 /*
  * There was a KeyPress or KeyRelease (both events have the same fields). We
- * compare this key code with our bindings table and pass the bound action to
- * parse_command().
+ * compare this key code with our bindings table and run the bound action
+ * using run_binding(), which does not generate a reply (see
+ * parse_command_noreply()).
  *
  */
 void handle_key_press(xcb_key_press_event_t *event) {
@@ -30,10 +31,5 @@ void handle_key_press(xcb_key_press_event_t *event) {
     if (bind == NULL)
         return;
 
-    CommandResult *result = run_binding(bind, NULL);
-
-    if (result->needs_tree_render)
-        tree_render();
-
-    command_result_free(result);
+    run_binding(bind, NULL);
 }
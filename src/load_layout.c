@@ -212,9 +212,11 @@ static int json_string(void *ctx, const unsigned char *val, size_t len) {
             json_node->name = scalloc((len + 1) * sizeof(char));
             memcpy(json_node->name, val, len);
         } else if (strcasecmp(last_key, "sticky_group") == 0) {
-            json_node->sticky_group = scalloc((len + 1) * sizeof(char));
-            memcpy(json_node->sticky_group, val, len);
-            LOG("sticky_group of this container is %s\n", json_node->sticky_group);
+            char *sticky_group = scalloc((len + 1) * sizeof(char));
+            memcpy(sticky_group, val, len);
+            LOG("sticky_group of this container is %s\n", sticky_group);
+            con_set_sticky_group(json_node, sticky_group);
+            free(sticky_group);
         } else if (strcasecmp(last_key, "orientation") == 0) {
             /* Upgrade path from older versions of i3 (doing an inplace restart
              * to a newer version):
@@ -88,6 +88,9 @@ struct ws_assignments_head ws_assignments = TAILQ_HEAD_INITIALIZER(ws_assignment
 /* We hope that those are supported and set them to true */
 bool xcursor_supported = true;
 
+/* Whether exec lines should be run (false with -a or on in-place restarts) */
+static bool autostart = true;
+
 /*
  * This callback is only a dummy, see xcb_prepare_cb and xcb_check_cb.
  * See also man libev(3): "ev_prepare" and "ev_check" - customise your event loop
@@ -98,13 +101,61 @@ static void xcb_got_event(EV_P_ struct ev_io *w, int revents) {
 }
 
 /*
- * Flush before blocking (and waiting for new events)
+ * Flush before blocking (and waiting for new events). The EWMH hints are
+ * written and the IPC events are sent here, so that they are updated at most
+ * once per iteration and describe the state after rendering.
  *
  */
 static void xcb_prepare_cb(EV_P_ ev_prepare *w, int revents) {
+    ipc_flush_events();
+    ewmh_flush_hints();
     xcb_flush(conn);
 }
 
+/*
+ * Starts the exec/exec_always commands and the bars.
+ *
+ */
+static void start_autostarts_and_bars(void) {
+    /* Autostarting exec-lines (only if autostart is enabled) and
+     * exec_always-lines */
+    timeline_begin("autostart");
+    autostart_run(autostart);
+    timeline_end("autostart");
+
+    /* Start i3bar processes for all configured bars */
+    Barconfig *barconfig;
+    TAILQ_FOREACH(barconfig, &barconfigs, configs) {
+        char *command = NULL;
+        sasprintf(&command, "%s --bar_id=%s --socket=\"%s\"",
+                  barconfig->i3bar_command ? barconfig->i3bar_command : "i3bar",
+                  barconfig->id, current_socketpath);
+        LOG("Starting bar process: %s\n", command);
+        start_application(command, true);
+        free(command);
+    }
+}
+
+/*
+ * Called once the event loop is idle for the first time, i.e. after the first
+ * frame was flushed to the X server. With fast_start, this is where the work
+ * which is not needed for the first frame is done.
+ *
+ */
+static void first_frame_cb(EV_P_ ev_idle *w, int revents) {
+    ev_idle_stop(EV_A_ w);
+    free(w);
+
+    timeline_end("first_frame");
+
+    if (config.fast_start) {
+        ewmh_update_desktop_names();
+        start_autostarts_and_bars();
+    }
+
+    timeline_finish();
+}
+
 /*
  * Instead of polling the X connection socket we leave this to
  * xcb_poll_for_event() which knows better than we can ever know.
@@ -129,6 +180,7 @@ static void xcb_check_cb(EV_P_ ev_check *w, int revents) {
         /* Strip off the highest bit (set if the event is generated) */
         int type = (event->response_type & 0x7F);
 
+        tree_snapshot_invalidate();
         handle_event(type, event);
 
         free(event);
@@ -190,7 +242,6 @@ int main(int argc, char *argv[]) {
      * it in gdb backtraces. */
     const char *i3_version __attribute__((unused)) = I3_VERSION;
     char *override_configpath = NULL;
-    bool autostart = true;
     char *layout_path = NULL;
     bool delete_layout_path = false;
     bool force_xinerama = false;
@@ -210,6 +261,7 @@ int main(int argc, char *argv[]) {
         {"force-xinerama", no_argument, 0, 0},
         {"force_xinerama", no_argument, 0, 0},
         {"disable-signalhandler", no_argument, 0, 0},
+        {"tree-history", no_argument, 0, 0},
         {"shmlog-size", required_argument, 0, 0},
         {"shmlog_size", required_argument, 0, 0},
         {"get-socketpath", no_argument, 0, 0},
@@ -292,6 +344,10 @@ int main(int argc, char *argv[]) {
                 } else if (strcmp(long_options[option_index].name, "disable-signalhandler") == 0) {
                     disable_signalhandler = true;
                     break;
+                } else if (strcmp(long_options[option_index].name, "tree-history") == 0) {
+                    LOG("Keeping the recent tree snapshots for crash reports\n");
+                    tree_snapshot_enable_history();
+                    break;
                 } else if (strcmp(long_options[option_index].name, "get-socketpath") == 0 ||
                            strcmp(long_options[option_index].name, "get_socketpath") == 0) {
                     char *socket_path = root_atom_contents("I3_SOCKET_PATH", NULL, 0);
@@ -344,6 +400,10 @@ int main(int argc, char *argv[]) {
                 fprintf(stderr, "\t--get-socketpath\n"
                                 "\tRetrieve the i3 IPC socket path from X11, print it, then exit.\n");
                 fprintf(stderr, "\n");
+                fprintf(stderr, "\t--tree-history\n"
+                                "\tKeep the recent snapshots of the layout tree taken for GET_TREE\n"
+                                "\trequests and save them after a crash (for bug reports).\n");
+                fprintf(stderr, "\n");
                 fprintf(stderr, "\t--shmlog-size <limit>\n"
                                 "\tLimits the size of the i3 SHM log to <limit> bytes. Setting this\n"
                                 "\tto 0 disables SHM logging entirely.\n"
@@ -458,9 +518,11 @@ int main(int argc, char *argv[]) {
 
     LOG("i3 " I3_VERSION " starting\n");
 
+    timeline_begin("x_connect");
     conn = xcb_connect(NULL, &conn_screen);
     if (xcb_connection_has_error(conn))
         errx(EXIT_FAILURE, "Cannot open display\n");
+    timeline_end("x_connect");
 
     sndisplay = sn_xcb_display_new(conn, NULL, NULL);
 
@@ -491,7 +553,20 @@ int main(int argc, char *argv[]) {
     xcb_get_geometry_cookie_t gcookie = xcb_get_geometry(conn, root);
     xcb_query_pointer_cookie_t pointercookie = xcb_query_pointer(conn, root);
 
+    /* After an in-place restart, reuse the font metrics of the old process,
+     * see i3_restart(). */
+    if (layout_path != NULL) {
+        char *font_cache_path;
+        sasprintf(&font_cache_path, "%s.fonts", layout_path);
+        font_cache_restore(font_cache_path);
+        if (delete_layout_path)
+            unlink(font_cache_path);
+        free(font_cache_path);
+    }
+
+    timeline_begin("config");
     load_configuration(conn, override_configpath, false);
+    timeline_end("config");
 
     if (config.ipc_socket_path == NULL) {
         /* Fall back to a file name in /tmp/ based on the PID */
@@ -575,7 +650,9 @@ int main(int argc, char *argv[]) {
     bool needs_tree_init = true;
     if (layout_path) {
         LOG("Trying to restore the layout from %s...", layout_path);
+        timeline_begin("tree_restore");
         needs_tree_init = !tree_restore(layout_path, greply);
+        timeline_end("tree_restore");
         if (delete_layout_path) {
             unlink(layout_path);
             const char *dir = dirname(layout_path);
@@ -585,8 +662,11 @@ int main(int argc, char *argv[]) {
         }
         free(layout_path);
     }
-    if (needs_tree_init)
+    if (needs_tree_init) {
+        timeline_begin("tree_init");
         tree_init(greply);
+        timeline_end("tree_init");
+    }
 
     free(greply);
 
@@ -594,6 +674,7 @@ int main(int argc, char *argv[]) {
     if (fake_outputs == NULL && config.fake_outputs != NULL)
         fake_outputs = config.fake_outputs;
 
+    timeline_begin("randr_init");
     if (fake_outputs != NULL) {
         fake_outputs_init(fake_outputs);
         FREE(fake_outputs);
@@ -607,6 +688,7 @@ int main(int argc, char *argv[]) {
         DLOG("Checking for XRandR...\n");
         randr_init(&randr_base);
     }
+    timeline_end("randr_init");
 
     scratchpad_fix_resolution();
 
@@ -626,7 +708,9 @@ int main(int argc, char *argv[]) {
         con_focus(con_descend_focused(output_get_content(output->con)));
     }
 
+    timeline_begin("tree_render");
     tree_render();
+    timeline_end("tree_render");
 
     /* Create the UNIX domain socket for IPC */
     int ipc_socket = ipc_create_socket(config.ipc_socket_path);
@@ -674,7 +758,10 @@ int main(int argc, char *argv[]) {
     /* Set the ewmh desktop properties. */
     ewmh_update_current_desktop();
     ewmh_update_number_of_desktops();
-    ewmh_update_desktop_names();
+    /* With fast_start, setting the desktop names is deferred, see
+     * first_frame_cb(). */
+    if (!config.fast_start)
+        ewmh_update_desktop_names();
     ewmh_update_desktop_viewport();
 
     struct ev_io *xcb_watcher = scalloc(sizeof(struct ev_io));
@@ -690,6 +777,12 @@ int main(int argc, char *argv[]) {
     ev_prepare_init(xcb_prepare, xcb_prepare_cb);
     ev_prepare_start(main_loop, xcb_prepare);
 
+    /* Idle watchers are only invoked after the prepare watchers (which flush
+     * the X connection) ran, so this one marks the first frame. */
+    struct ev_idle *first_frame = scalloc(sizeof(struct ev_idle));
+    ev_idle_init(first_frame, first_frame_cb);
+    ev_idle_start(main_loop, first_frame);
+
     xcb_flush(conn);
 
     /* What follows is a fugly consequence of X11 protocol race conditions like
@@ -726,7 +819,9 @@ int main(int argc, char *argv[]) {
 
             free(event);
         }
+        timeline_begin("manage_existing_windows");
         manage_existing_windows(root);
+        timeline_end("manage_existing_windows");
     }
     xcb_ungrab_server(conn);
 
@@ -781,33 +876,10 @@ int main(int argc, char *argv[]) {
      * while we are sending them a message */
     signal(SIGPIPE, SIG_IGN);
 
-    /* Autostarting exec-lines */
-    if (autostart) {
-        struct Autostart *exec;
-        TAILQ_FOREACH(exec, &autostarts, autostarts) {
-            LOG("auto-starting %s\n", exec->command);
-            start_application(exec->command, exec->no_startup_id);
-        }
-    }
-
-    /* Autostarting exec_always-lines */
-    struct Autostart *exec_always;
-    TAILQ_FOREACH(exec_always, &autostarts_always, autostarts_always) {
-        LOG("auto-starting (always!) %s\n", exec_always->command);
-        start_application(exec_always->command, exec_always->no_startup_id);
-    }
-
-    /* Start i3bar processes for all configured bars */
-    Barconfig *barconfig;
-    TAILQ_FOREACH(barconfig, &barconfigs, configs) {
-        char *command = NULL;
-        sasprintf(&command, "%s --bar_id=%s --socket=\"%s\"",
-                  barconfig->i3bar_command ? barconfig->i3bar_command : "i3bar",
-                  barconfig->id, current_socketpath);
-        LOG("Starting bar process: %s\n", command);
-        start_application(command, true);
-        free(command);
-    }
+    /* With fast_start, applications are started once the first frame was
+     * pushed, see first_frame_cb(). */
+    if (!config.fast_start)
+        start_autostarts_and_bars();
 
     /* Make sure to destroy the event loop to invoke the cleeanup callbacks
      * when calling exit() */
@@ -167,6 +167,7 @@ void manage_window(xcb_window_t window, xcb_get_window_attributes_cookie_t cooki
     i3Window *cwindow = scalloc(sizeof(i3Window));
     cwindow->id = window;
     cwindow->depth = get_visual_depth(attr->visual);
+    cwindow->wm_desktop = NET_WM_DESKTOP_NONE;
 
     /* We need to grab the mouse buttons for click to focus */
     xcb_grab_button(conn, false, window, XCB_EVENT_MASK_BUTTON_PRESS,
@@ -189,6 +190,12 @@ void manage_window(xcb_window_t window, xcb_get_window_attributes_cookie_t cooki
     window_update_name_legacy(cwindow, xcb_get_property_reply(conn, title_cookie, NULL), true);
     window_update_name(cwindow, xcb_get_property_reply(conn, utf8_title_cookie, NULL), true);
     window_update_leader(cwindow, xcb_get_property_reply(conn, leader_cookie, NULL));
+    /* If the window has no _NET_STARTUP_ID, we need the one of its leader.
+     * Request it right away so that it is pipelined with the replies we are
+     * still waiting for instead of costing an extra round trip later. */
+    xcb_get_property_reply_t *startup_id_reply;
+    startup_id_reply = xcb_get_property_reply(conn, startup_id_cookie, NULL);
+    xcb_get_property_cookie_t leader_startup_id_cookie = startup_leader_startup_id(cwindow, startup_id_reply);
     window_update_transient_for(cwindow, xcb_get_property_reply(conn, transient_cookie, NULL));
     window_update_strut_partial(cwindow, xcb_get_property_reply(conn, strut_cookie, NULL));
     window_update_role(cwindow, xcb_get_property_reply(conn, role_cookie, NULL), true);
@@ -202,9 +209,10 @@ void manage_window(xcb_window_t window, xcb_get_window_attributes_cookie_t cooki
     xcb_get_property_reply_t *type_reply = xcb_get_property_reply(conn, wm_type_cookie, NULL);
     xcb_get_property_reply_t *state_reply = xcb_get_property_reply(conn, state_cookie, NULL);
 
-    xcb_get_property_reply_t *startup_id_reply;
-    startup_id_reply = xcb_get_property_reply(conn, startup_id_cookie, NULL);
-    char *startup_ws = startup_workspace_for_window(cwindow, startup_id_reply);
+    xcb_get_property_reply_t *leader_startup_id_reply = NULL;
+    if (leader_startup_id_cookie.sequence != 0)
+        leader_startup_id_reply = xcb_get_property_reply(conn, leader_startup_id_cookie, NULL);
+    char *startup_ws = startup_workspace_for_window(cwindow, startup_id_reply, leader_startup_id_reply);
     DLOG("startup workspace = %s\n", startup_ws);
 
     /* check if the window needs WM_TAKE_FOCUS */
@@ -311,6 +319,9 @@ void manage_window(xcb_window_t window, xcb_get_window_attributes_cookie_t cooki
     }
     nc->window = cwindow;
     x_reinit(nc);
+    /* Also pushes the state of containers which were already fullscreen
+     * before swallowing this window. */
+    ewmh_update_window_hints(nc);
 
     nc->border_width = geom->border_width;
 
@@ -524,6 +535,9 @@ void manage_window(xcb_window_t window, xcb_get_window_attributes_cookie_t cooki
      * needs to be on the final workspace first. */
     con_set_urgency(nc, urgency_hint);
 
+    /* Start autostarts which were waiting for a window of this class. */
+    autostart_window_managed(cwindow);
+
 geom_out:
     free(geom);
 out:
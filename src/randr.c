@@ -29,6 +29,27 @@ struct outputs_head outputs = TAILQ_HEAD_INITIALIZER(outputs);
 
 static bool randr_disabled = false;
 
+/* What randr_query_outputs() found to be different from the previous query.
+ * Only the outputs which are added, removed or changed are touched, and when
+ * nothing changed at all, the tree is left alone. */
+static struct {
+    int added;
+    int removed;
+    int changed;
+    bool primary_changed;
+} outputs_diff;
+
+/* The active outputs, sorted by their x coordinate, so that the outputs which
+ * may contain a point can be found with a binary search. Only valid while
+ * output_index_valid is set, that is, not while outputs are being changed. */
+static Output **output_index;
+static int output_index_len;
+static bool output_index_valid;
+
+/* The width of the widest active output. Outputs which contain a point with
+ * x coordinate x must start at x - max_output_width or later. */
+static uint32_t max_output_width;
+
 /*
  * Get a specific output by its internal X11 id. Used by randr_query_outputs
  * to check if the output is new (only in the first scan) or if we are
@@ -66,7 +87,7 @@ Output *get_first_output(void) {
     Output *output;
 
     TAILQ_FOREACH(output, &outputs, outputs)
-    if (output->active)
+    if (output->active && !output->to_be_disabled)
         return output;
 
     die("No usable outputs available.\n");
@@ -79,6 +100,34 @@ Output *get_first_output(void) {
  */
 Output *get_output_containing(unsigned int x, unsigned int y) {
     Output *output;
+
+    if (output_index_valid) {
+        /* Find the first output which starts after x… */
+        int lo = 0, hi = output_index_len;
+        while (lo < hi) {
+            const int mid = (lo + hi) / 2;
+            if (output_index[mid]->rect.x <= x)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        /* …and walk back over the outputs which start close enough to x to
+         * contain it. Of all outputs containing x, y, the first one in the
+         * outputs list wins. */
+        Output *best = NULL;
+        for (int i = lo - 1; i >= 0; i--) {
+            output = output_index[i];
+            if ((int64_t)output->rect.x + max_output_width <= x)
+                break;
+            if (x < (output->rect.x + output->rect.width) &&
+                y >= output->rect.y && y < (output->rect.y + output->rect.height) &&
+                (best == NULL || output->position < best->position))
+                best = output;
+        }
+        return best;
+    }
+
     TAILQ_FOREACH(output, &outputs, outputs) {
         if (!output->active)
             continue;
@@ -148,17 +197,11 @@ Output *get_output_next_wrap(direction_t direction, Output *current) {
 }
 
 /*
- * Gets the output which is the next one in the given direction.
- *
- * If close_far == CLOSEST_OUTPUT, then the output next to the current one will
- * selected. If close_far == FARTHEST_OUTPUT, the output which is the last one
- * in the given direction will be selected.
- *
- * NULL will be returned when no active outputs are present in the direction
- * specified (note that “current” counts as such an output).
+ * Searches all active outputs for the next one in the given direction, see
+ * get_output_next().
  *
  */
-Output *get_output_next(direction_t direction, Output *current, output_close_far_t close_far) {
+static Output *output_next_search(direction_t direction, Output *current, output_close_far_t close_far) {
     Rect *cur = &(current->rect),
          *other;
     Output *output,
@@ -215,10 +258,86 @@ Output *get_output_next(direction_t direction, Output *current, output_close_far
         }
     }
 
+    return best;
+}
+
+/*
+ * Gets the output which is the next one in the given direction.
+ *
+ * If close_far == CLOSEST_OUTPUT, then the output next to the current one will
+ * selected. If close_far == FARTHEST_OUTPUT, the output which is the last one
+ * in the given direction will be selected.
+ *
+ * NULL will be returned when no active outputs are present in the direction
+ * specified (note that “current” counts as such an output).
+ *
+ */
+Output *get_output_next(direction_t direction, Output *current, output_close_far_t close_far) {
+    Output *best;
+    if (output_index_valid && current->active)
+        best = current->neighbors[direction][close_far];
+    else
+        best = output_next_search(direction, current, close_far);
+
     DLOG("current = %s, best = %s\n", current->name, (best ? best->name : "NULL"));
     return best;
 }
 
+/*
+ * Orders outputs by their x coordinate, for qsort().
+ *
+ */
+static int output_index_cmp(const void *a, const void *b) {
+    const Output *first = *(Output *const *)a,
+                 *second = *(Output *const *)b;
+    if (first->rect.x != second->rect.x)
+        return (first->rect.x < second->rect.x ? -1 : 1);
+    return first->position - second->position;
+}
+
+/*
+ * Rebuilds the index of the active outputs (sorted by x coordinate, with the
+ * neighbors of each output precomputed), which get_output_containing() and
+ * get_output_next() use instead of comparing all outputs. Needs to be called
+ * whenever outputs are added, removed or changed.
+ *
+ */
+void randr_update_output_index(void) {
+    Output *output;
+    int num = 0;
+    TAILQ_FOREACH(output, &outputs, outputs)
+    num++;
+
+    output_index = srealloc(output_index, (num + 1) * sizeof(Output *));
+    output_index_len = 0;
+    max_output_width = 0;
+    int position = 0;
+    TAILQ_FOREACH(output, &outputs, outputs) {
+        output->position = position++;
+        if (!output->active)
+            continue;
+        output_index[output_index_len++] = output;
+        max_output_width = max(max_output_width, output->rect.width);
+    }
+
+    qsort(output_index, output_index_len, sizeof(Output *), output_index_cmp);
+
+    /* The neighbors only change together with the outputs, so they are
+     * computed here once instead of on every lookup. */
+    for (int i = 0; i < output_index_len; i++) {
+        output = output_index[i];
+        for (direction_t direction = D_LEFT; direction <= D_DOWN; direction++) {
+            output->neighbors[direction][CLOSEST_OUTPUT] =
+                output_next_search(direction, output, CLOSEST_OUTPUT);
+            output->neighbors[direction][FARTHEST_OUTPUT] =
+                output_next_search(direction, output, FARTHEST_OUTPUT);
+        }
+    }
+
+    output_index_valid = true;
+    DLOG("Indexed %d active outputs\n", output_index_len);
+}
+
 /*
  * Disables RandR support by creating exactly one output with the size of the
  * X11 screen.
@@ -241,6 +360,7 @@ void disable_randr(xcb_connection_t *conn) {
     TAILQ_INSERT_TAIL(&outputs, s, outputs);
 
     randr_disabled = true;
+    randr_update_output_index();
 }
 
 /*
@@ -524,7 +644,10 @@ static void handle_output(xcb_connection_t *conn, xcb_randr_output_t id,
     if (!existing)
         new = scalloc(sizeof(Output));
     new->id = id;
+    const bool was_primary = new->primary;
     new->primary = (primary && primary->output == id);
+    if (new->primary != was_primary)
+        outputs_diff.primary_changed = true;
     FREE(new->name);
     sasprintf(&new->name, "%.*s",
               xcb_randr_get_output_info_name_length(output),
@@ -560,9 +683,12 @@ static void handle_output(xcb_connection_t *conn, xcb_randr_output_t id,
                    update_if_necessary(&(new->rect.width), crtc->width) |
                    update_if_necessary(&(new->rect.height), crtc->height);
     free(crtc);
+    const bool was_active = new->active;
     new->active = (new->rect.width != 0 && new->rect.height != 0);
     if (!new->active) {
         DLOG("width/height 0/0, disabling output\n");
+        if (was_active)
+            outputs_diff.changed++;
         return;
     }
 
@@ -588,8 +714,12 @@ static void handle_output(xcb_connection_t *conn, xcb_randr_output_t id,
 /*
  * (Re-)queries the outputs via RandR and stores them in the list of outputs.
  *
+ * Only the outputs which were added, removed or changed (mode, position or
+ * primary) are updated in the tree. Returns false if nothing changed at all,
+ * in which case the tree is neither changed nor rendered.
+ *
  */
-void randr_query_outputs(void) {
+bool randr_query_outputs(void) {
     Output *output, *other, *first;
     xcb_randr_get_output_primary_cookie_t pcookie;
     xcb_randr_get_screen_resources_current_cookie_t rcookie;
@@ -603,7 +733,13 @@ void randr_query_outputs(void) {
     xcb_randr_output_t *randr_outputs;
 
     if (randr_disabled)
-        return;
+        return false;
+
+    memset(&outputs_diff, 0, sizeof(outputs_diff));
+
+    /* The outputs are changed from here on, so lookups need to search all
+     * outputs until the index is rebuilt. */
+    output_index_valid = false;
 
     /* Get screen resources (primary output, crtcs, outputs, modes) */
     rcookie = xcb_randr_get_screen_resources_current(conn, root);
@@ -615,7 +751,8 @@ void randr_query_outputs(void) {
         DLOG("primary output is %08x\n", primary->output);
     if ((res = xcb_randr_get_screen_resources_current_reply(conn, rcookie, NULL)) == NULL) {
         disable_randr(conn);
-        return;
+        FREE(primary);
+        return true;
     }
     cts = res->config_timestamp;
 
@@ -682,10 +819,11 @@ void randr_query_outputs(void) {
      * LVDS1 active, VGA1 gets activated as a clone of LVDS1 (has no con).
      * LVDS1 gets disabled. */
     TAILQ_FOREACH(output, &outputs, outputs) {
-        if (output->active && output->con == NULL) {
+        if (output->active && !output->to_be_disabled && output->con == NULL) {
             DLOG("Need to initialize a Con for output %s\n", output->name);
             output_init_con(output);
             output->changed = false;
+            outputs_diff.added++;
         }
     }
 
@@ -695,6 +833,8 @@ void randr_query_outputs(void) {
         if (output->to_be_disabled) {
             output->active = false;
             DLOG("Output %s disabled, re-assigning workspaces/docks\n", output->name);
+            if (output->con != NULL)
+                outputs_diff.removed++;
 
             first = get_first_output();
 
@@ -773,15 +913,33 @@ void randr_query_outputs(void) {
             output->changed = false;
         }
 
-        if (output->changed) {
+        /* Clones are reported with their own mode and then reduced to the
+         * common mode again, so compare with the rect the output had before. */
+        if (output->changed &&
+            memcmp(&(output->con->rect), &(output->rect), sizeof(Rect)) != 0) {
             output_change_mode(conn, output);
-            output->changed = false;
+            outputs_diff.changed++;
         }
+        output->changed = false;
     }
 
     if (TAILQ_EMPTY(&outputs)) {
         ELOG("No outputs found via RandR, disabling\n");
         disable_randr(conn);
+        outputs_diff.added++;
+    }
+
+    randr_update_output_index();
+
+    DLOG("Outputs: %d added, %d removed, %d changed, primary %s\n",
+         outputs_diff.added, outputs_diff.removed, outputs_diff.changed,
+         (outputs_diff.primary_changed ? "changed" : "unchanged"));
+    if (outputs_diff.added == 0 && outputs_diff.removed == 0 &&
+        outputs_diff.changed == 0 && !outputs_diff.primary_changed) {
+        DLOG("Effective output configuration unchanged, not touching the tree.\n");
+        FREE(res);
+        FREE(primary);
+        return false;
     }
 
     /* Verifies that there is at least one active output as a side-effect. */
@@ -798,9 +956,11 @@ void randr_query_outputs(void) {
         init_ws_for_output(output, content);
     }
 
-    /* Focus the primary screen, if possible */
+    /* Focus the primary screen, if possible (and if it changed, so that
+     * merely plugging in or reconfiguring another output does not move the
+     * focus) */
     TAILQ_FOREACH(output, &outputs, outputs) {
-        if (!output->primary || !output->con)
+        if (!outputs_diff.primary_changed || !output->primary || !output->con)
             continue;
 
         DLOG("Focusing primary output %s\n", output->name);
@@ -812,6 +972,7 @@ void randr_query_outputs(void) {
 
     FREE(res);
     FREE(primary);
+    return true;
 }
 
 /*
@@ -458,4 +458,8 @@ void render_con(Con *con, bool render_fullscreen) {
                 x_raise_con(con);
         }
     }
+
+    if (con->type == CT_WORKSPACE &&
+        config.directional_focus == DIRECTIONAL_FOCUS_GEOMETRIC)
+        focus_index_update(con);
 }
@@ -27,6 +27,10 @@ typedef struct placeholder_state {
     /** The graphics context for “pixmap”. */
     xcb_gcontext_t gc;
 
+    /** Whether the pixmap needs to be drawn by the next
+     * update_placeholders(). */
+    bool needs_redraw;
+
     TAILQ_ENTRY(placeholder_state) state;
 } placeholder_state;
 
@@ -40,6 +44,7 @@ static struct ev_check *xcb_check;
 static struct ev_prepare *xcb_prepare;
 
 static void restore_handle_event(int type, xcb_generic_event_t *event);
+static void update_placeholders(void);
 
 /* Documentation for these functions can be found in src/main.c, starting at xcb_got_event */
 static void restore_xcb_got_event(EV_P_ struct ev_io *w, int revents) {
@@ -74,6 +79,8 @@ static void restore_xcb_check_cb(EV_P_ ev_check *w, int revents) {
 
         free(event);
     }
+
+    update_placeholders();
 }
 
 /*
@@ -123,16 +130,26 @@ void restore_connect(void) {
     ev_prepare_start(main_loop, xcb_prepare);
 }
 
-static void update_placeholder_contents(placeholder_state *state) {
+/*
+ * Fills the pixmap of the given placeholder with the background color. This
+ * happens on the placeholder connection.
+ *
+ */
+static void draw_placeholder_background(placeholder_state *state) {
     xcb_change_gc(restore_conn, state->gc, XCB_GC_FOREGROUND,
                   (uint32_t[]){config.client.placeholder.background});
     xcb_poly_fill_rectangle(restore_conn, state->pixmap, state->gc, 1,
                             (xcb_rectangle_t[]){{0, 0, state->rect.width, state->rect.height}});
+}
 
-    // TODO: make i3font functions per-connection, at least these two for now…?
-    xcb_flush(restore_conn);
-    xcb_aux_sync(restore_conn);
-
+/*
+ * Draws the swallow criteria and the watch symbol onto the pixmap of the given
+ * placeholder. The i3font functions only work on the main connection, so this
+ * must only be called once the pixmap and graphics context were created on the
+ * placeholder connection (see update_placeholders()).
+ *
+ */
+static void draw_placeholder_text(placeholder_state *state, i3String *watch, int watch_width) {
     set_font_colors(state->gc, config.client.placeholder.text, config.client.placeholder.background);
 
     Match *swallows;
@@ -168,14 +185,58 @@ static void update_placeholder_contents(placeholder_state *state) {
     }
 
     // TODO: render the watch symbol in a bigger font
-    i3String *line = i3string_from_utf8("⌚");
-    int text_width = predict_text_width(line);
-    int x = (state->rect.width / 2) - (text_width / 2);
+    int x = (state->rect.width / 2) - (watch_width / 2);
     int y = (state->rect.height / 2) - (config.font.height / 2);
-    draw_text(line, state->pixmap, state->gc, x, y, text_width);
-    i3string_free(line);
+    draw_text(watch, state->pixmap, state->gc, x, y, watch_width);
+}
+
+/*
+ * Draws the contents of all placeholders which need to be redrawn (because
+ * they were just created or resized) and copies them to their windows.
+ *
+ * Drawing uses both connections: the backgrounds are filled on the
+ * placeholder connection, the text is drawn on the main connection. Each
+ * connection is therefore synced once per call instead of once per
+ * placeholder, which matters when restoring layouts with many windows.
+ *
+ */
+static void update_placeholders(void) {
+    placeholder_state *state;
+    int num = 0;
+    TAILQ_FOREACH(state, &state_head, state) {
+        if (!state->needs_redraw)
+            continue;
+        draw_placeholder_background(state);
+        num++;
+    }
+
+    if (num == 0)
+        return;
+
+    // TODO: make i3font functions per-connection, at least these two for now…?
+    xcb_flush(restore_conn);
+    xcb_aux_sync(restore_conn);
+
+    i3String *watch = i3string_from_utf8("⌚");
+    int watch_width = predict_text_width(watch);
+    TAILQ_FOREACH(state, &state_head, state) {
+        if (state->needs_redraw)
+            draw_placeholder_text(state, watch, watch_width);
+    }
+    i3string_free(watch);
     xcb_flush(conn);
     xcb_aux_sync(conn);
+
+    TAILQ_FOREACH(state, &state_head, state) {
+        if (!state->needs_redraw)
+            continue;
+        xcb_copy_area(restore_conn, state->pixmap, state->window, state->gc,
+                      0, 0, 0, 0, state->rect.width, state->rect.height);
+        state->needs_redraw = false;
+    }
+    xcb_flush(restore_conn);
+
+    DLOG("Drew %d placeholder windows\n", num);
 }
 
 static void open_placeholder_window(Con *con) {
@@ -219,7 +280,9 @@ static void open_placeholder_window(Con *con) {
                           state->window, state->rect.width, state->rect.height);
         state->gc = xcb_generate_id(restore_conn);
         xcb_create_gc(restore_conn, state->gc, state->pixmap, XCB_GC_GRAPHICS_EXPOSURES, (uint32_t[]){0});
-        update_placeholder_contents(state);
+        /* The contents are drawn for all new placeholders at once, see
+         * restore_open_placeholder_windows(). */
+        state->needs_redraw = true;
         TAILQ_INSERT_TAIL(&state_head, state, state);
 
         /* create temporary id swallow to match the placeholder */
@@ -246,6 +309,8 @@ static void open_placeholder_window(Con *con) {
  *
  */
 void restore_open_placeholder_windows(Con *parent) {
+    const double start = ev_time();
+
     Con *child;
     TAILQ_FOREACH(child, &(parent->nodes_head), nodes) {
         open_placeholder_window(child);
@@ -254,7 +319,9 @@ void restore_open_placeholder_windows(Con *parent) {
         open_placeholder_window(child);
     }
 
-    xcb_flush(restore_conn);
+    update_placeholders();
+
+    LOG("Opened placeholder windows in %.1f ms\n", (ev_time() - start) * 1000);
 }
 
 /*
@@ -307,8 +374,10 @@ static void expose_event(xcb_expose_event_t *event) {
 
 /*
  * Window size has changed. Update the width/height, then recreate the back
- * buffer pixmap and the accompanying graphics context and force an immediate
- * re-rendering.
+ * buffer pixmap and the accompanying graphics context. The contents are drawn
+ * once all pending events were handled (see restore_xcb_check_cb()), so that
+ * resizing many placeholders at once (e.g. when restoring a layout) only costs
+ * one round trip.
  *
  */
 static void configure_notify(xcb_configure_notify_event_t *event) {
@@ -332,10 +401,7 @@ static void configure_notify(xcb_configure_notify_event_t *event) {
         state->gc = xcb_generate_id(restore_conn);
         xcb_create_gc(restore_conn, state->gc, state->pixmap, XCB_GC_GRAPHICS_EXPOSURES, (uint32_t[]){0});
 
-        update_placeholder_contents(state);
-        xcb_copy_area(restore_conn, state->pixmap, state->window, state->gc,
-                      0, 0, 0, 0, state->rect.width, state->rect.height);
-        xcb_flush(restore_conn);
+        state->needs_redraw = true;
         return;
     }
 
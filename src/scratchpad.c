@@ -11,6 +11,39 @@
  */
 #include "all.h"
 
+/* All scratchpad windows (their floating containers) which are currently
+ * shown, that is, not on __i3_scratch. The most recently shown window comes
+ * first. Hidden scratchpad windows are in the floating_head of __i3_scratch,
+ * in the order in which they will be shown. */
+static TAILQ_HEAD(scratchpad_shown_head, Con) scratchpad_shown =
+    TAILQ_HEAD_INITIALIZER(scratchpad_shown);
+
+/*
+ * Updates the list of shown scratchpad windows after the given floating
+ * container was attached to a workspace (or closed, if closing is true).
+ * Scratchpad windows which are not on __i3_scratch are considered shown.
+ *
+ */
+void scratchpad_update(Con *con, bool closing) {
+    if (con->type != CT_FLOATING_CON)
+        return;
+
+    if (con->scratchpad_shown) {
+        TAILQ_REMOVE(&scratchpad_shown, con, scratchpad_windows);
+        con->scratchpad_shown = false;
+    }
+
+    if (closing || con->scratchpad_state == SCRATCHPAD_NONE)
+        return;
+
+    Con *ws = con_get_workspace(con);
+    if (ws == NULL || con_is_internal(ws))
+        return;
+
+    TAILQ_INSERT_HEAD(&scratchpad_shown, con, scratchpad_windows);
+    con->scratchpad_shown = true;
+}
+
 /*
  * Moves the specified window to the __i3_scratch workspace, making it floating
  * and setting the appropriate scratchpad_state.
@@ -113,33 +146,29 @@ void scratchpad_show(Con *con) {
     }
 
     /* If this was 'scratchpad show' without criteria, we check if there is a
-     * unfocused scratchpad on the current workspace and focus it */
+     * unfocused scratchpad on the current workspace and focus it. Otherwise,
+     * if there is a visible scratchpad window on another workspace, we move
+     * it to the current workspace. Both are found in the (short) list of
+     * shown scratchpad windows instead of searching the whole tree. */
     Con *walk_con;
     Con *focused_ws = con_get_workspace(focused);
-    TAILQ_FOREACH(walk_con, &(focused_ws->floating_head), floating_windows) {
-        if (!con && (floating = con_inside_floating(walk_con)) &&
-            floating->scratchpad_state != SCRATCHPAD_NONE &&
-            floating != con_inside_floating(focused)) {
+    if (!con) {
+        TAILQ_FOREACH(walk_con, &scratchpad_shown, scratchpad_windows) {
+            if (con_get_workspace(walk_con) != focused_ws ||
+                walk_con == con_inside_floating(focused))
+                continue;
             DLOG("Found an unfocused scratchpad window on this workspace\n");
             DLOG("Focusing it: %p\n", walk_con);
             /* use con_descend_tiling_focused to get the last focused
-                 * window inside this scratch container in order to
-                 * keep the focus the same within this container */
+             * window inside this scratch container in order to
+             * keep the focus the same within this container */
             con_focus(con_descend_tiling_focused(walk_con));
             return;
         }
-    }
 
-    /* If this was 'scratchpad show' without criteria, we check if there is a
-     * visible scratchpad window on another workspace. In this case we move it
-     * to the current workspace. */
-    focused_ws = con_get_workspace(focused);
-    TAILQ_FOREACH(walk_con, &all_cons, all_cons) {
-        Con *walk_ws = con_get_workspace(walk_con);
-        if (!con && walk_ws &&
-            !con_is_internal(walk_ws) && focused_ws != walk_ws &&
-            (floating = con_inside_floating(walk_con)) &&
-            floating->scratchpad_state != SCRATCHPAD_NONE) {
+        TAILQ_FOREACH(walk_con, &scratchpad_shown, scratchpad_windows) {
+            if (con_get_workspace(walk_con) == focused_ws)
+                continue;
             DLOG("Found a visible scratchpad window on another workspace,\n");
             DLOG("moving it to this workspace: con = %p\n", walk_con);
             con_move_to_workspace(walk_con, focused_ws, true, false);
@@ -127,6 +127,30 @@ static int backtrace(void) {
     return 1;
 }
 
+/*
+ * Saves the recent tree snapshots to i3-tree-history.$pid in the tmpdir, next
+ * to the backtrace.
+ *
+ */
+static void save_tree_history(void) {
+    char *tmpdir = getenv("TMPDIR");
+    if (tmpdir == NULL)
+        tmpdir = "/tmp";
+
+    char *filename = NULL;
+    int suffix = 0;
+    struct stat bt;
+    do {
+        FREE(filename);
+        sasprintf(&filename, "%s/i3-tree-history.%d.%d.json", tmpdir, getpid(), suffix);
+        suffix++;
+    } while (stat(filename, &bt) == 0);
+
+    if (tree_snapshot_dump_history(filename))
+        DLOG("Saved the tree history to \"%s\"\n", filename);
+    free(filename);
+}
+
 /*
  * Draw the window containing the info text
  *
@@ -189,6 +213,7 @@ static int sig_handle_key_press(void *ignored, xcb_connection_t *conn, xcb_key_p
         /* fork and exec/attach GDB to the parent to get a backtrace in the
          * tmpdir */
         backtrace_done = backtrace();
+        save_tree_history();
 
         /* re-open the windows to indicate that it's finished */
         open_popups();
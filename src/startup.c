@@ -25,6 +25,40 @@
 static TAILQ_HEAD(startup_sequence_head, Startup_Sequence) startup_sequences =
     TAILQ_HEAD_INITIALIZER(startup_sequences);
 
+/* The startup sequences are additionally indexed by their ID, since we need to
+ * look up the sequence for every new window (and every libstartup-notification
+ * event). The buckets are zero-initialized, which is a valid empty LIST. */
+#define STARTUP_SEQUENCE_BUCKETS 64
+static LIST_HEAD(startup_sequence_bucket, Startup_Sequence) startup_sequence_index[STARTUP_SEQUENCE_BUCKETS];
+
+/*
+ * Returns the index bucket for the startup ID of the given length (the ID does
+ * not need to be NUL-terminated, since it is usually taken straight from the
+ * _NET_STARTUP_ID property).
+ *
+ */
+static struct startup_sequence_bucket *startup_sequence_bucket(const char *id, size_t len) {
+    /* djb2 */
+    uint32_t hash = 5381;
+    for (size_t i = 0; i < len; i++)
+        hash = ((hash << 5) + hash) + (unsigned char)id[i];
+    return &startup_sequence_index[hash % STARTUP_SEQUENCE_BUCKETS];
+}
+
+/*
+ * Returns the startup sequence with the given ID (of the given length), or
+ * NULL if there is no such sequence.
+ *
+ */
+static struct Startup_Sequence *startup_sequence_by_id(const char *id, size_t len) {
+    struct Startup_Sequence *current;
+    LIST_FOREACH(current, startup_sequence_bucket(id, len), by_id) {
+        if (strncmp(current->id, id, len) == 0 && current->id[len] == '\0')
+            return current;
+    }
+    return NULL;
+}
+
 /*
  * After 60 seconds, a timeout will be triggered for each startup sequence.
  *
@@ -36,14 +70,7 @@ static void startup_timeout(EV_P_ ev_timer *w, int revents) {
     const char *id = sn_launcher_context_get_startup_id(w->data);
     DLOG("Timeout for startup sequence %s\n", id);
 
-    struct Startup_Sequence *current, *sequence = NULL;
-    TAILQ_FOREACH(current, &startup_sequences, sequences) {
-        if (strcmp(current->id, id) != 0)
-            continue;
-
-        sequence = current;
-        break;
-    }
+    struct Startup_Sequence *sequence = startup_sequence_by_id(id, strlen(id));
 
     /* Unref the context (for the timeout itself, see start_application) */
     sn_launcher_context_unref(w->data);
@@ -106,11 +133,16 @@ void startup_sequence_delete(struct Startup_Sequence *sequence) {
     DLOG("Deleting startup sequence %s, delete_at = %ld, current_time = %ld\n",
          sequence->id, sequence->delete_at, time(NULL));
 
+    /* Let the exec queue start the next autostart, in case this sequence was
+     * not completed yet. */
+    autostart_sequence_completed(sequence);
+
     /* Unref the context, will be free()d */
     sn_launcher_context_unref(sequence->context);
 
     /* Delete our internal sequence */
     TAILQ_REMOVE(&startup_sequences, sequence, sequences);
+    LIST_REMOVE(sequence, by_id);
 
     free(sequence->id);
     free(sequence->workspace);
@@ -129,9 +161,13 @@ void startup_sequence_delete(struct Startup_Sequence *sequence) {
  * The no_startup_id flag determines whether a startup notification context
  * (and ID) should be created, which is the default and encouraged behavior.
  *
+ * Returns the startup sequence which was created for this application, or
+ * NULL if no_startup_id was set.
+ *
  */
-void start_application(const char *command, bool no_startup_id) {
+struct Startup_Sequence *start_application(const char *command, bool no_startup_id) {
     SnLauncherContext *context;
+    struct Startup_Sequence *sequence = NULL;
 
     if (!no_startup_id) {
         /* Create a startup notification context to monitor the progress of this
@@ -159,11 +195,12 @@ void start_application(const char *command, bool no_startup_id) {
         /* Save the ID and current workspace in our internal list of startup
          * sequences */
         Con *ws = con_get_workspace(focused);
-        struct Startup_Sequence *sequence = scalloc(sizeof(struct Startup_Sequence));
+        sequence = scalloc(sizeof(struct Startup_Sequence));
         sequence->id = sstrdup(sn_launcher_context_get_startup_id(context));
         sequence->workspace = sstrdup(ws->name);
         sequence->context = context;
         TAILQ_INSERT_TAIL(&startup_sequences, sequence, sequences);
+        LIST_INSERT_HEAD(startup_sequence_bucket(sequence->id, strlen(sequence->id)), sequence, by_id);
 
         /* Increase the refcount once (it starts with 1, so it will be 2 now) for
          * the timeout. Even if the sequence gets completed, the timeout still
@@ -205,6 +242,8 @@ void start_application(const char *command, bool no_startup_id) {
         else
             xcb_set_root_cursor(XCURSOR_CURSOR_WATCH);
     }
+
+    return sequence;
 }
 
 /*
@@ -218,14 +257,7 @@ void startup_monitor_event(SnMonitorEvent *event, void *userdata) {
 
     /* Get the corresponding internal startup sequence */
     const char *id = sn_startup_sequence_get_id(snsequence);
-    struct Startup_Sequence *current, *sequence = NULL;
-    TAILQ_FOREACH(current, &startup_sequences, sequences) {
-        if (strcmp(current->id, id) != 0)
-            continue;
-
-        sequence = current;
-        break;
-    }
+    struct Startup_Sequence *sequence = startup_sequence_by_id(id, strlen(id));
 
     if (!sequence) {
         DLOG("Got event for startup sequence that we did not initiate (ID = %s). Ignoring.\n", id);
@@ -242,6 +274,8 @@ void startup_monitor_event(SnMonitorEvent *event, void *userdata) {
             DLOG("Will delete startup sequence %s at timestamp %ld\n",
                  sequence->id, sequence->delete_at);
 
+            autostart_sequence_completed(sequence);
+
             if (_prune_startup_sequences() == 0) {
                 DLOG("No more startup sequences running, changing root window cursor to default pointer.\n");
                 /* Change the pointer of the root window to indicate progress */
@@ -273,19 +307,46 @@ void startup_sequence_rename_workspace(char *old_name, char *new_name) {
     }
 }
 
+/**
+ * Requests the _NET_STARTUP_ID of the given window’s leader (if it has one and
+ * the window itself has no _NET_STARTUP_ID) without waiting for the reply, so
+ * that the request can be pipelined with other requests. The reply needs to be
+ * passed to startup_sequence_get().
+ *
+ * Returns a cookie with sequence number 0 if the request is not necessary.
+ *
+ */
+xcb_get_property_cookie_t startup_leader_startup_id(i3Window *cwindow, xcb_get_property_reply_t *startup_id_reply) {
+    xcb_get_property_cookie_t cookie = {0};
+    if (cwindow->leader == XCB_NONE ||
+        (startup_id_reply != NULL && xcb_get_property_value_length(startup_id_reply) > 0))
+        return cookie;
+
+    return xcb_get_property(conn, false, cwindow->leader,
+                            A__NET_STARTUP_ID, XCB_GET_PROPERTY_TYPE_ANY, 0, 512);
+}
+
 /**
  * Gets the stored startup sequence for the _NET_STARTUP_ID of a given window.
  *
+ * If the window has no _NET_STARTUP_ID, the one of its leader is used, which
+ * is passed in leader_startup_id_reply (see startup_leader_startup_id()). Both
+ * replies are freed.
+ *
  */
 struct Startup_Sequence *startup_sequence_get(i3Window *cwindow,
-                                              xcb_get_property_reply_t *startup_id_reply, bool ignore_mapped_leader) {
+                                              xcb_get_property_reply_t *startup_id_reply,
+                                              xcb_get_property_reply_t *leader_startup_id_reply,
+                                              bool ignore_mapped_leader) {
     /* The _NET_STARTUP_ID is only needed during this function, so we get it
      * here and don’t save it in the 'cwindow'. */
     if (startup_id_reply == NULL || xcb_get_property_value_length(startup_id_reply) == 0) {
         FREE(startup_id_reply);
         DLOG("No _NET_STARTUP_ID set on window 0x%08x\n", cwindow->id);
-        if (cwindow->leader == XCB_NONE)
+        if (cwindow->leader == XCB_NONE) {
+            FREE(leader_startup_id_reply);
             return NULL;
+        }
 
         /* This is a special case that causes the leader's startup sequence
          * to only be returned if it has never been mapped, useful primarily
@@ -296,51 +357,29 @@ struct Startup_Sequence *startup_sequence_get(i3Window *cwindow,
          * likely permanently unmapped and the child is the "real" window. */
         if (ignore_mapped_leader && con_by_window_id(cwindow->leader) != NULL) {
             DLOG("Ignoring leader window 0x%08x\n", cwindow->leader);
+            FREE(leader_startup_id_reply);
             return NULL;
         }
 
         DLOG("Checking leader window 0x%08x\n", cwindow->leader);
 
-        xcb_get_property_cookie_t cookie;
-
-        cookie = xcb_get_property(conn, false, cwindow->leader,
-                                  A__NET_STARTUP_ID, XCB_GET_PROPERTY_TYPE_ANY, 0, 512);
-        startup_id_reply = xcb_get_property_reply(conn, cookie, NULL);
-
+        startup_id_reply = leader_startup_id_reply;
         if (startup_id_reply == NULL ||
             xcb_get_property_value_length(startup_id_reply) == 0) {
             FREE(startup_id_reply);
             DLOG("No _NET_STARTUP_ID set on the leader either\n");
             return NULL;
         }
+    } else {
+        FREE(leader_startup_id_reply);
     }
 
-    char *startup_id;
-    if (asprintf(&startup_id, "%.*s", xcb_get_property_value_length(startup_id_reply),
-                 (char *)xcb_get_property_value(startup_id_reply)) == -1) {
-        perror("asprintf()");
-        DLOG("Could not get _NET_STARTUP_ID\n");
-        free(startup_id_reply);
-        return NULL;
-    }
-
-    struct Startup_Sequence *current, *sequence = NULL;
-    TAILQ_FOREACH(current, &startup_sequences, sequences) {
-        if (strcmp(current->id, startup_id) != 0)
-            continue;
-
-        sequence = current;
-        break;
-    }
-
-    if (!sequence) {
-        DLOG("WARNING: This sequence (ID %s) was not found\n", startup_id);
-        free(startup_id);
-        free(startup_id_reply);
-        return NULL;
-    }
+    const char *startup_id = (const char *)xcb_get_property_value(startup_id_reply);
+    const int startup_id_len = xcb_get_property_value_length(startup_id_reply);
+    struct Startup_Sequence *sequence = startup_sequence_by_id(startup_id, startup_id_len);
+    if (!sequence)
+        DLOG("WARNING: This sequence (ID %.*s) was not found\n", startup_id_len, startup_id);
 
-    free(startup_id);
     free(startup_id_reply);
 
     return sequence;
@@ -355,8 +394,9 @@ struct Startup_Sequence *startup_sequence_get(i3Window *cwindow,
  * Returns NULL otherwise.
  *
  */
-char *startup_workspace_for_window(i3Window *cwindow, xcb_get_property_reply_t *startup_id_reply) {
-    struct Startup_Sequence *sequence = startup_sequence_get(cwindow, startup_id_reply, false);
+char *startup_workspace_for_window(i3Window *cwindow, xcb_get_property_reply_t *startup_id_reply,
+                                   xcb_get_property_reply_t *leader_startup_id_reply) {
+    struct Startup_Sequence *sequence = startup_sequence_get(cwindow, startup_id_reply, leader_startup_id_reply, false);
     if (sequence == NULL)
         return NULL;
 
@@ -368,5 +408,8 @@ char *startup_workspace_for_window(i3Window *cwindow, xcb_get_property_reply_t *
         return NULL;
     }
 
+    /* If this is the first window of an autostarted command, record it. */
+    autostart_sequence_mapped(sequence);
+
     return sequence->workspace;
 }
@@ -0,0 +1,134 @@
+#undef I3__FILE__
+#define I3__FILE__ "timeline.c"
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * timeline.c: Records how long the phases of i3’s startup take (connecting to
+ *             X, parsing the config, initializing the outputs, …).
+ *
+ */
+#include "all.h"
+#include "encoder_utils.h"
+
+#include <time.h>
+
+/* The startup is split into less than a dozen phases, so a fixed-size array
+ * is enough. */
+#define MAX_PHASES 16
+
+static struct phase {
+    const char *name;
+    /* Milliseconds since the first recorded phase began. */
+    double start;
+    double end;
+} phases[MAX_PHASES];
+
+static int num_phases;
+
+static struct timespec timeline_start;
+
+static bool finished;
+
+/*
+ * Returns the number of milliseconds since the first phase began, using the
+ * monotonic clock so that changes of the system time do not matter.
+ *
+ */
+static double timeline_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (timeline_start.tv_sec == 0 && timeline_start.tv_nsec == 0) {
+        timeline_start = now;
+        return 0;
+    }
+    return (now.tv_sec - timeline_start.tv_sec) * 1000.0 +
+           (now.tv_nsec - timeline_start.tv_nsec) / 1000000.0;
+}
+
+/*
+ * Returns the most recently begun phase with the given name, or NULL.
+ *
+ */
+static struct phase *phase_by_name(const char *name) {
+    for (int i = num_phases - 1; i >= 0; i--) {
+        if (strcmp(phases[i].name, name) == 0)
+            return &phases[i];
+    }
+    return NULL;
+}
+
+/*
+ * Records the beginning of the given startup phase. The name is not copied and
+ * thus needs to be a string literal.
+ *
+ */
+void timeline_begin(const char *phase) {
+    if (finished)
+        return;
+
+    if (num_phases == MAX_PHASES) {
+        ELOG("Too many startup phases, not recording \"%s\"\n", phase);
+        return;
+    }
+
+    struct phase *current = &phases[num_phases++];
+    current->name = phase;
+    current->start = current->end = timeline_now();
+}
+
+/*
+ * Records the end of the given startup phase and logs its duration. If the
+ * phase was not begun, it is recorded as a point in time.
+ *
+ */
+void timeline_end(const char *phase) {
+    if (finished)
+        return;
+
+    struct phase *current = phase_by_name(phase);
+    if (current == NULL) {
+        timeline_begin(phase);
+        if ((current = phase_by_name(phase)) == NULL)
+            return;
+    }
+
+    current->end = timeline_now();
+    LOG("Startup phase %s took %.1f ms (done after %.1f ms)\n",
+        current->name, current->end - current->start, current->end);
+}
+
+/*
+ * Stops recording startup phases. Called once the first frame was pushed to
+ * the X server, so that later config reloads do not show up in the timeline.
+ *
+ */
+void timeline_finish(void) {
+    finished = true;
+}
+
+/*
+ * Dumps the recorded startup phases as a JSON array, for the GET_STARTUP IPC
+ * reply.
+ *
+ */
+void timeline_dump(ipc_encoder *gen) {
+    y(array_open);
+    for (int i = 0; i < num_phases; i++) {
+        y(map_open);
+
+        ystr("name");
+        ystr(phases[i].name);
+
+        ystr("start");
+        y(double, phases[i].start);
+
+        ystr("duration");
+        y(double, phases[i].end - phases[i].start);
+
+        y(map_close);
+    }
+    y(array_close);
+}
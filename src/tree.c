@@ -16,6 +16,16 @@ struct Con *focused;
 
 struct all_cons_head all_cons = TAILQ_HEAD_INITIALIZER(all_cons);
 
+/* After this many seconds, the tree is rendered even if not all windows
+ * killed by tree_close_many() went away (the user might have cancelled
+ * closing some of them). */
+#define BULK_CLOSE_TIMEOUT 1.0
+
+/* Number of windows killed by tree_close_many() which were not closed yet. */
+static int bulk_close_pending;
+
+static struct ev_timer *bulk_close_timer;
+
 /*
  * Create the pseudo-output __i3. Output-independent workspaces such as
  * __i3_scratch will live there.
@@ -192,6 +202,7 @@ static bool _is_con_mapped(Con *con) {
 bool tree_close(Con *con, kill_window_t kill_window, bool dont_kill_parent, bool force_set_focus) {
     bool was_mapped = con->mapped;
     Con *parent = con->parent;
+    const bool defer_render = tree_close_defers_render(con);
 
     if (!was_mapped) {
         /* Even if the container itself is not mapped, its children may be
@@ -265,6 +276,9 @@ bool tree_close(Con *con, kill_window_t kill_window, bool dont_kill_parent, bool
             add_ignore_event(cookie.sequence, 0);
         }
         ipc_send_window_event("close", con);
+        /* The window is freed below, so the queued events have to be
+         * serialized now. */
+        ipc_forget_con(con);
         FREE(con->window->class_class);
         FREE(con->window->class_instance);
         i3string_free(con->window->name);
@@ -290,6 +304,11 @@ bool tree_close(Con *con, kill_window_t kill_window, bool dont_kill_parent, bool
     /* Detach the container so that it will not be rendered anymore. */
     con_detach(con);
 
+    /* Queued events which refer to this container have to be serialized
+     * before any of its fields are freed (e.g. the “old” workspace of a focus
+     * event when switching away from an empty workspace). */
+    ipc_forget_con(con);
+
     /* disable urgency timer, if needed */
     if (con->urgency_timer != NULL) {
         DLOG("Removing urgency timer of con %p\n", con);
@@ -312,7 +331,7 @@ bool tree_close(Con *con, kill_window_t kill_window, bool dont_kill_parent, bool
      * Rendering has to be avoided when dont_kill_parent is set (when
      * tree_close calls itself recursively) because the tree is in a
      * non-renderable state during that time. */
-    if (!dont_kill_parent)
+    if (!dont_kill_parent && !defer_render)
         tree_render();
 
     /* kill the X11 part of this container */
@@ -326,6 +345,14 @@ bool tree_close(Con *con, kill_window_t kill_window, bool dont_kill_parent, bool
 
     free(con->name);
     FREE(con->deco_render_params);
+    focus_index_free(con);
+    ewmh_forget_con(con);
+    con_set_sticky_group(con, NULL);
+    scratchpad_update(con, true);
+    if (con->bulk_close && --bulk_close_pending == 0 && bulk_close_timer != NULL) {
+        ev_timer_stop(main_loop, bulk_close_timer);
+        FREE(bulk_close_timer);
+    }
     TAILQ_REMOVE(&all_cons, con, all_cons);
     free(con);
 
@@ -362,6 +389,117 @@ bool tree_close(Con *con, kill_window_t kill_window, bool dont_kill_parent, bool
     return true;
 }
 
+/*
+ * Renders the tree when some of the windows killed by tree_close_many() did
+ * not go away in time.
+ *
+ */
+static void bulk_close_timeout(EV_P_ ev_timer *w, int revents) {
+    DLOG("%d windows of the bulk close are still open, rendering now.\n", bulk_close_pending);
+    ev_timer_stop(main_loop, bulk_close_timer);
+    FREE(bulk_close_timer);
+
+    Con *con;
+    TAILQ_FOREACH(con, &all_cons, all_cons)
+    con->bulk_close = false;
+    bulk_close_pending = 0;
+
+    tree_render();
+}
+
+/*
+ * Returns true if the given container was killed by tree_close_many() and
+ * other windows of the same bulk close are still open. Closing it does not
+ * need to render the tree then, as the tree will be rendered once the last of
+ * these windows is gone.
+ *
+ */
+bool tree_close_defers_render(Con *con) {
+    return (con->bulk_close && bulk_close_pending > 1);
+}
+
+/*
+ * Appends the containers of the windows of the given container and all its
+ * children to the windows array.
+ *
+ */
+static void tree_collect_windows(Con *con, Con ***windows, int *num_windows) {
+    Con *child;
+    TAILQ_FOREACH(child, &(con->nodes_head), nodes)
+    tree_collect_windows(child, windows, num_windows);
+
+    if (con->window == NULL)
+        return;
+
+    /* remove the urgency hint of the workspace (if set), just like
+     * tree_close() does */
+    if (con->urgent) {
+        con->urgent = false;
+        con_update_parents_urgency(con);
+        workspace_update_urgent_flag(con_get_workspace(con));
+    }
+
+    *windows = srealloc(*windows, (*num_windows + 1) * sizeof(Con *));
+    (*windows)[(*num_windows)++] = con;
+}
+
+/*
+ * Closes all the given containers, like calling tree_close() for each of them.
+ * The kill requests for all windows are sent in one batch, and the tree is
+ * rendered only once, when the last of these windows is gone, instead of once
+ * per window.
+ *
+ */
+void tree_close_many(Con **cons, int num, kill_window_t kill_window) {
+    Con **windows = NULL;
+    int num_windows = 0;
+
+    for (int i = 0; i < num; i++) {
+        const int before = num_windows;
+        tree_collect_windows(cons[i], &windows, &num_windows);
+
+        /* Containers without any windows can be closed right away. */
+        if (num_windows == before)
+            tree_close(cons[i], kill_window, false, false);
+    }
+
+    if (num_windows == 0)
+        return;
+
+    /* A single window is killed just like tree_close() does it. There is
+     * nothing to batch, and if the window does not close (e.g. because it
+     * asks whether to save a file), there is no render to catch up on. */
+    if (num_windows == 1) {
+        x_window_kill(windows[0]->window->id, kill_window);
+        free(windows);
+        return;
+    }
+
+    /* Mark the containers as being closed in bulk, see
+     * tree_close_defers_render(). */
+    xcb_window_t *ids = smalloc(num_windows * sizeof(xcb_window_t));
+    for (int i = 0; i < num_windows; i++) {
+        ids[i] = windows[i]->window->id;
+        if (!windows[i]->bulk_close) {
+            windows[i]->bulk_close = true;
+            bulk_close_pending++;
+        }
+    }
+    free(windows);
+
+    DLOG("Killing %d windows in one batch\n", num_windows);
+    x_window_kill_many(ids, num_windows, kill_window);
+    free(ids);
+
+    if (bulk_close_timer != NULL) {
+        ev_timer_stop(main_loop, bulk_close_timer);
+        FREE(bulk_close_timer);
+    }
+    bulk_close_timer = scalloc(sizeof(struct ev_timer));
+    ev_timer_init(bulk_close_timer, bulk_close_timeout, BULK_CLOSE_TIMEOUT, 0.);
+    ev_timer_start(main_loop, bulk_close_timer);
+}
+
 /*
  * Closes the current container using tree_close().
  *
@@ -375,19 +513,26 @@ void tree_close_con(kill_window_t kill_window) {
 
     if (focused->type == CT_WORKSPACE) {
         DLOG("Workspaces cannot be close, closing all children instead\n");
-        Con *child, *nextchild;
-        for (child = TAILQ_FIRST(&(focused->focus_head)); child;) {
-            nextchild = TAILQ_NEXT(child, focused);
-            DLOG("killing child=%p\n", child);
-            tree_close(child, kill_window, false, false);
-            child = nextchild;
-        }
+        int num = 0;
+        Con *child;
+        TAILQ_FOREACH(child, &(focused->focus_head), focused)
+        num++;
+        if (num == 0)
+            return;
+
+        Con **children = smalloc(num * sizeof(Con *));
+        num = 0;
+        TAILQ_FOREACH(child, &(focused->focus_head), focused)
+        children[num++] = child;
 
+        tree_close_many(children, num, kill_window);
+        free(children);
         return;
     }
 
-    /* Kill con */
-    tree_close(focused, kill_window, false, false);
+    /* Kill con (and all its children, in one batch) */
+    Con *con = focused;
+    tree_close_many(&con, 1, kill_window);
 }
 
 /*
@@ -523,6 +668,10 @@ void tree_render(void) {
     mark_unmapped(croot);
     croot->mapped = true;
 
+    /* Render the pre-warmed hidden workspaces first, so that the windows of
+     * the visible workspaces are raised above them. */
+    workspace_prewarm();
+
     render_con(croot, false);
 
     x_push_changes(croot);
@@ -696,6 +845,23 @@ static bool _tree_next(Con *con, char way, orientation_t orientation, bool wrap)
  *
  */
 void tree_next(char way, orientation_t orientation) {
+    if (config.directional_focus == DIRECTIONAL_FOCUS_GEOMETRIC) {
+        direction_t direction;
+        if (orientation == HORIZ)
+            direction = (way == 'n' ? D_RIGHT : D_LEFT);
+        else
+            direction = (way == 'n' ? D_DOWN : D_UP);
+
+        /* Floating and fullscreen containers, containers inside stacked or
+         * tabbed containers and moving focus to another output are still
+         * handled by walking the tree. */
+        Con *next = focus_index_next(focused, direction);
+        if (next != NULL && con_fullscreen_permits_focusing(next)) {
+            con_focus(con_descend_focused(next));
+            return;
+        }
+    }
+
     _tree_next(focused, way, orientation, true);
 }
 
@@ -0,0 +1,201 @@
+#undef I3__FILE__
+#define I3__FILE__ "tree_snapshot.c"
+/*
+ * vim:ts=4:sw=4:expandtab
+ *
+ * i3 - an improved dynamic tiling window manager
+ * © 2009-2015 Michael Stapelberg and contributors (see also: LICENSE)
+ *
+ * tree_snapshot.c: Immutable, versioned snapshots of the layout tree which
+ *                  can be read while (or after) the live tree is modified.
+ *
+ * i3 modifies containers in place all over the code base, so instead of
+ * sharing unchanged subtrees between versions, each snapshot is a complete
+ * copy of the tree in CBOR (see ipc_encoder.c), as dumped for GET_TREE.
+ * Snapshots are only taken when a client asks for the tree, and the latest one
+ * is reused until the tree might have changed, so repeated requests do not
+ * dump the tree again. Restarting needs a different flavor of the dump (see
+ * dump_node()), which is generated from the live tree only when restarting.
+ *
+ * Snapshots are reference-counted and never modified after they were taken,
+ * so readers (e.g. the GET_TREE worker threads) do not need to lock anything.
+ * Only the latest snapshot is kept, unless i3 was started with
+ * --tree-history, in which case the recent ones are kept and saved for the
+ * bug report after a crash.
+ *
+ */
+#include "all.h"
+#include "encoder_utils.h"
+
+#include <fcntl.h>
+#include <locale.h>
+
+/* Number of snapshots which are kept for tree_snapshot_dump_history() when
+ * the history is enabled. */
+#define HISTORY_SIZE 16
+
+struct tree_snapshot {
+    uint64_t version;
+    /* When the snapshot was taken (in seconds since the epoch). */
+    double taken_at;
+    /* Modified atomically, references may be released on other threads. */
+    int refcount;
+    /* The tree as dumped for GET_TREE. */
+    ipc_encoder *layout;
+};
+
+/* Ring buffer of the most recent snapshots, history_next is the slot which
+ * will be overwritten next. */
+static tree_snapshot *history[HISTORY_SIZE];
+static int history_next;
+/* Number of slots of the ring buffer which are used, 1 unless the history
+ * was enabled using tree_snapshot_enable_history(). */
+static int history_size = 1;
+
+static uint64_t next_version = 1;
+/* Set when the tree might have changed since the latest snapshot was taken. */
+static bool outdated = true;
+
+/*
+ * Keeps the HISTORY_SIZE most recent snapshots instead of only the latest
+ * one, so that they can be saved after a crash. Enabled by --tree-history.
+ *
+ */
+void tree_snapshot_enable_history(void) {
+    history_size = HISTORY_SIZE;
+}
+
+/*
+ * Marks the latest snapshot as outdated. Called before anything which might
+ * modify the tree is done, i.e. before handling X11 events and commands, and
+ * by x_push_changes() (renders triggered by timers).
+ *
+ */
+void tree_snapshot_invalidate(void) {
+    outdated = true;
+}
+
+static tree_snapshot *latest(void) {
+    return history[(history_next + history_size - 1) % history_size];
+}
+
+/*
+ * Returns a reference to a snapshot of the current tree. The latest snapshot
+ * is reused unless it is outdated, otherwise a new one is taken. Release the
+ * reference with tree_snapshot_unref().
+ *
+ */
+tree_snapshot *tree_snapshot_take(void) {
+    if (!outdated && latest() != NULL)
+        return tree_snapshot_ref(latest());
+
+    tree_snapshot *snapshot = scalloc(sizeof(tree_snapshot));
+    snapshot->version = next_version++;
+    snapshot->taken_at = ev_time();
+    /* The reference held by the history. */
+    snapshot->refcount = 1;
+    /* Doubles are stored in binary, so the locale does not matter here. */
+    snapshot->layout = ipc_encoder_new(IPC_ENCODING_CBOR);
+    dump_node(snapshot->layout, croot, false);
+
+    if (history[history_next] != NULL)
+        tree_snapshot_unref(history[history_next]);
+    history[history_next] = snapshot;
+    history_next = (history_next + 1) % history_size;
+    outdated = false;
+
+    return tree_snapshot_ref(snapshot);
+}
+
+/*
+ * Acquires a reference to the given snapshot. Snapshots are never modified,
+ * so they may be passed to other threads.
+ *
+ */
+tree_snapshot *tree_snapshot_ref(tree_snapshot *snapshot) {
+    __atomic_add_fetch(&(snapshot->refcount), 1, __ATOMIC_RELAXED);
+    return snapshot;
+}
+
+/*
+ * Releases a reference to the given snapshot, freeing it once the last
+ * reference is gone.
+ *
+ */
+void tree_snapshot_unref(tree_snapshot *snapshot) {
+    if (__atomic_sub_fetch(&(snapshot->refcount), 1, __ATOMIC_ACQ_REL) > 0)
+        return;
+
+    ipc_encoder_free(snapshot->layout);
+    free(snapshot);
+}
+
+/*
+ * Returns the version of the given snapshot. Versions increase with every
+ * snapshot that is taken.
+ *
+ */
+uint64_t tree_snapshot_version(tree_snapshot *snapshot) {
+    return snapshot->version;
+}
+
+/*
+ * Returns the tree contained in the given snapshot, in the CBOR encoding of
+ * dump_node() (as sent for GET_TREE). It remains valid as long as the
+ * reference is held.
+ *
+ */
+void tree_snapshot_get_layout(tree_snapshot *snapshot, const unsigned char **buf, size_t *length) {
+    ipc_encoder_get_buf(snapshot->layout, buf, length);
+}
+
+/*
+ * Writes the kept snapshots (oldest first) as a JSON array to the given file.
+ * Returns false on errors.
+ *
+ */
+bool tree_snapshot_dump_history(const char *filename) {
+    setlocale(LC_NUMERIC, "C");
+    ipc_encoder *gen = ipc_encoder_new(IPC_ENCODING_JSON);
+
+    y(array_open);
+    for (int i = 0; i < history_size; i++) {
+        tree_snapshot *snapshot = history[(history_next + i) % history_size];
+        if (snapshot == NULL)
+            continue;
+
+        y(map_open);
+        ystr("version");
+        y(integer, snapshot->version);
+        ystr("time");
+        y(double, snapshot->taken_at);
+        ystr("layout");
+        const unsigned char *layout;
+        size_t layout_length;
+        tree_snapshot_get_layout(snapshot, &layout, &layout_length);
+        ipc_encoder_append_cbor(gen, layout, layout_length);
+        y(map_close);
+    }
+    y(array_close);
+
+    setlocale(LC_NUMERIC, "");
+
+    const unsigned char *payload;
+    size_t length;
+    ipc_encoder_get_buf(gen, &payload, &length);
+
+    bool success = false;
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (fd == -1) {
+        ELOG("Could not open \"%s\" for the tree history: %s\n", filename, strerror(errno));
+    } else {
+        if (writeall(fd, payload, length) == -1)
+            ELOG("Could not write the tree history to \"%s\": %s\n", filename, strerror(errno));
+        else
+            success = true;
+        close(fd);
+    }
+
+    ipc_encoder_free(gen);
+    return success;
+}
@@ -223,12 +223,9 @@ static char **append_argument(char **original, char *argument) {
     return result;
 }
 
-#define y(x, ...) yajl_gen_##x(gen, ##__VA_ARGS__)
-#define ystr(str) yajl_gen_string(gen, (unsigned char *)str, strlen(str))
-
 char *store_restart_layout(void) {
     setlocale(LC_NUMERIC, "C");
-    yajl_gen gen = yajl_gen_alloc(NULL);
+    ipc_encoder *gen = ipc_encoder_new(IPC_ENCODING_JSON);
 
     dump_node(gen, croot, true);
 
@@ -236,7 +233,7 @@ char *store_restart_layout(void) {
 
     const unsigned char *payload;
     size_t length;
-    y(get_buf, &payload, &length);
+    ipc_encoder_get_buf(gen, &payload, &length);
 
     /* create a temporary file if one hasn't been specified, or just
      * resolve the tildes in the specified path */
@@ -278,7 +275,7 @@ char *store_restart_layout(void) {
         DLOG("layout: %.*s\n", (int)length, payload);
     }
 
-    y(free);
+    ipc_encoder_free(gen);
 
     return filename;
 }
@@ -291,6 +288,15 @@ char *store_restart_layout(void) {
 void i3_restart(bool forget_layout) {
     char *restart_filename = forget_layout ? NULL : store_restart_layout();
 
+    /* Save the font metrics next to the layout, so that the new process does
+     * not need to query them again (see main()). */
+    if (restart_filename != NULL) {
+        char *font_cache_path;
+        sasprintf(&font_cache_path, "%s.fonts", restart_filename);
+        font_cache_save(font_cache_path);
+        free(font_cache_path);
+    }
+
     kill_nagbar(&config_error_nagbar_pid, true);
     kill_nagbar(&command_error_nagbar_pid, true);
 
@@ -11,12 +11,19 @@
  *
  */
 #include "all.h"
-#include "yajl_utils.h"
 
 /* Stores a copy of the name of the last used workspace for the workspace
  * back-and-forth switching. */
 static char *previous_workspace_name = NULL;
 
+/* Names of the most recently shown workspaces, most recent first. Used to
+ * pick the workspaces which are pre-warmed, see workspace_prewarm(). */
+#define WORKSPACE_HISTORY_SIZE 8
+static char *workspace_history[WORKSPACE_HISTORY_SIZE];
+
+/* All sticky groups which contain at least one container */
+struct sticky_groups_head sticky_groups = TAILQ_HEAD_INITIALIZER(sticky_groups);
+
 /*
  * Sets ws->layout to splith/splitv if default_orientation was specified in the
  * configfile. Otherwise, it uses splith/splitv depending on whether the output
@@ -235,81 +242,217 @@ bool workspace_is_visible(Con *ws) {
 }
 
 /*
- * XXX: we need to clean up all this recursive walking code.
+ * Returns a container of the given sticky group which holds the group’s window
+ * and is on the given output, or NULL.
  *
  */
-Con *_get_sticky(Con *con, const char *sticky_group, Con *exclude) {
+static Con *sticky_group_get_window_con(struct Sticky_Group *group, Con *output, Con *exclude) {
     Con *current;
+    TAILQ_FOREACH(current, &(group->cons_head), sticky_cons) {
+        if (current == exclude || current->window == NULL)
+            continue;
 
-    TAILQ_FOREACH(current, &(con->nodes_head), nodes) {
-        if (current != exclude &&
-            current->sticky_group != NULL &&
-            current->window != NULL &&
-            strcmp(current->sticky_group, sticky_group) == 0)
+        Con *ws = con_get_workspace(current);
+        if (ws != NULL && con_get_output(ws) == output)
             return current;
+    }
+
+    return NULL;
+}
+
+/*
+ * Reassigns the windows of all sticky groups which have a container on the
+ * given workspace to that container. Called when the user changes
+ * workspaces.
+ *
+ * Uses the registry of sticky groups (see con_set_sticky_group()), so this
+ * does nothing when there are no sticky groups and otherwise only looks at
+ * the containers of each group.
+ *
+ */
+static void workspace_reassign_sticky(Con *ws) {
+    struct Sticky_Group *group;
+    TAILQ_FOREACH(group, &sticky_groups, sticky_groups) {
+        Con *current;
+        TAILQ_FOREACH(current, &(group->cons_head), sticky_cons) {
+            if (con_get_workspace(current) != ws)
+                continue;
+
+            LOG("Ah, this one is sticky: %s / %p\n", current->name, current);
+            /* find a window which we can re-assign */
+            Con *src = sticky_group_get_window_con(group, con_get_output(ws), current);
+            if (src == NULL) {
+                LOG("No window found for this sticky group\n");
+                continue;
+            }
+
+            x_move_win(src, current);
+            current->window = src->window;
+            current->mapped = true;
+            src->window = NULL;
+            src->mapped = false;
 
-        Con *recurse = _get_sticky(current, sticky_group, exclude);
-        if (recurse != NULL)
-            return recurse;
+            x_reparent_child(current, src);
+
+            LOG("re-assigned window from src %p to dest %p\n", src, current);
+        }
     }
+}
 
-    TAILQ_FOREACH(current, &(con->floating_head), floating_windows) {
-        if (current != exclude &&
-            current->sticky_group != NULL &&
-            current->window != NULL &&
-            strcmp(current->sticky_group, sticky_group) == 0)
-            return current;
+/*
+ * Moves the given workspace name to the front of the workspace history.
+ *
+ */
+static void workspace_history_add(const char *name) {
+    /* Find the existing entry, or use the last (oldest) one */
+    int i;
+    for (i = 0; i < WORKSPACE_HISTORY_SIZE - 1; i++) {
+        if (workspace_history[i] != NULL &&
+            strcmp(workspace_history[i], name) == 0)
+            break;
+    }
+
+    free(workspace_history[i]);
+    memmove(&workspace_history[1], &workspace_history[0], i * sizeof(char *));
+    workspace_history[0] = sstrdup(name);
+}
 
-        Con *recurse = _get_sticky(current, sticky_group, exclude);
-        if (recurse != NULL)
-            return recurse;
+/*
+ * Renames the given workspace in the workspace history, so that it is still
+ * pre-warmed after “rename workspace”.
+ *
+ */
+void workspace_history_rename(const char *old_name, const char *new_name) {
+    for (int i = 0; i < WORKSPACE_HISTORY_SIZE; i++) {
+        if (workspace_history[i] == NULL ||
+            strcmp(workspace_history[i], old_name) != 0)
+            continue;
+        free(workspace_history[i]);
+        workspace_history[i] = sstrdup(new_name);
     }
+}
 
-    return NULL;
+/*
+ * Estimates the memory used by the pixmaps of the given container and its
+ * children, based on their last rendered size (and 32 bits per pixel).
+ *
+ */
+static uint64_t con_pixmap_bytes(Con *con) {
+    uint64_t bytes = 0;
+    if (con_is_leaf(con) || con->layout == L_STACKED || con->layout == L_TABBED)
+        bytes += (uint64_t)con->rect.width * con->rect.height * 4;
+
+    Con *child;
+    TAILQ_FOREACH(child, &(con->nodes_head), nodes)
+    bytes += con_pixmap_bytes(child);
+    return bytes;
 }
 
 /*
- * Reassigns all child windows in sticky containers. Called when the user
- * changes workspaces.
+ * Sets or clears the pre-warmed flag of the given (hidden) container and its
+ * children. Pre-warmed containers stay unmapped but get their decorations
+ * drawn.
  *
- * XXX: what about sticky containers which contain containers?
+ */
+static void set_prewarmed(Con *con, bool prewarmed) {
+    Con *child;
+
+    con->mapped = false;
+    con->prewarmed = prewarmed;
+    TAILQ_FOREACH(child, &(con->nodes_head), nodes)
+    set_prewarmed(child, prewarmed);
+}
+
+/*
+ * Renders the most recently shown hidden workspaces (as long as their
+ * pixmaps fit into the workspace_prewarm budget) without mapping them, so
+ * that their layout and decorations are ready when switching to them. Only
+ * workspaces which changed since they were last pre-warmed are rendered
+ * again. Called by tree_render() before rendering the visible workspaces.
  *
  */
-static void workspace_reassign_sticky(Con *con) {
-    Con *current;
-    /* 1: go through all containers */
+void workspace_prewarm(void) {
+    /* Whether any workspace was pre-warmed by the last call. If so, the
+     * workspaces have to cool down even when pre-warming was disabled in the
+     * meantime (by reloading the config). */
+    static bool active = false;
+    if (config.workspace_prewarm == 0 && !active)
+        return;
 
-    /* handle all children and floating windows of this node */
-    TAILQ_FOREACH(current, &(con->nodes_head), nodes) {
-        if (current->sticky_group == NULL) {
-            workspace_reassign_sticky(current);
+    /* Pick the workspaces which fit into the budget. */
+    Con *warm[WORKSPACE_HISTORY_SIZE];
+    int num_warm = 0;
+    uint64_t budget = (uint64_t)config.workspace_prewarm * 1024 * 1024;
+    for (int i = 0; budget > 0 && i < WORKSPACE_HISTORY_SIZE && workspace_history[i] != NULL; i++) {
+        Con *output, *ws = NULL;
+        TAILQ_FOREACH(output, &(croot->nodes_head), nodes)
+        GREP_FIRST(ws, output_get_content(output), !strcasecmp(child->name, workspace_history[i]));
+
+        if (ws == NULL ||
+            con_is_internal(ws) ||
+            workspace_is_visible(ws) ||
+            TAILQ_EMPTY(&(ws->nodes_head)))
             continue;
-        }
 
-        LOG("Ah, this one is sticky: %s / %p\n", current->name, current);
-        /* 2: find a window which we can re-assign */
-        Con *output = con_get_output(current);
-        Con *src = _get_sticky(output, current->sticky_group, current);
+        /* Workspaces which were never rendered have no size yet, so we assume
+         * that they need at least one pixmap covering the whole output. */
+        Con *content = ws->parent;
+        uint64_t bytes = con_pixmap_bytes(ws);
+        uint64_t min_bytes = (uint64_t)content->rect.width * content->rect.height * 4;
+        if (bytes < min_bytes)
+            bytes = min_bytes;
 
-        if (src == NULL) {
-            LOG("No window found for this sticky group\n");
-            workspace_reassign_sticky(current);
-            continue;
+        if (bytes > budget) {
+            DLOG("Not pre-warming workspace %s, it exceeds the remaining budget\n", ws->name);
+            break;
         }
+        budget -= bytes;
+        warm[num_warm++] = ws;
+    }
 
-        x_move_win(src, current);
-        current->window = src->window;
-        current->mapped = true;
-        src->window = NULL;
-        src->mapped = false;
+    /* Render the picked workspaces unless they are still warm, and let the
+     * others (including the visible ones) cool down. A warm workspace might
+     * still be outdated in other ways (e.g. its layout was changed using
+     * criteria), but it is rendered completely when it is shown anyway. */
+    Con *output, *ws;
+    TAILQ_FOREACH(output, &(croot->nodes_head), nodes) {
+        TAILQ_FOREACH(ws, &(output_get_content(output)->nodes_head), nodes) {
+            bool picked = false;
+            for (int i = 0; i < num_warm && !picked; i++)
+                picked = (warm[i] == ws);
+
+            if (!picked) {
+                if (ws->prewarmed)
+                    set_prewarmed(ws, false);
+                continue;
+            }
 
-        x_reparent_child(current, src);
+            Con *content = ws->parent;
+            if (ws->prewarmed && !ws->prewarm_dirty &&
+                memcmp(&(ws->rect), &(content->rect), sizeof(Rect)) == 0)
+                continue;
 
-        LOG("re-assigned window from src %p to dest %p\n", src, current);
+            DLOG("Pre-warming workspace %s\n", ws->name);
+            ws->rect = content->rect;
+            render_con(ws, false);
+            set_prewarmed(ws, true);
+            ws->prewarm_dirty = false;
+        }
     }
 
-    TAILQ_FOREACH(current, &(con->floating_head), floating_windows)
-    workspace_reassign_sticky(current);
+    active = (num_warm > 0);
+}
+
+/*
+ * Marks the workspace of the given container as changed, so that
+ * workspace_prewarm() renders it again. Called when containers are attached
+ * or detached.
+ *
+ */
+void workspace_prewarm_invalidate(Con *con) {
+    Con *ws = con_get_workspace(con);
+    if (ws != NULL)
+        ws->prewarm_dirty = true;
 }
 
 /*
@@ -369,6 +512,7 @@ static void _workspace_show(Con *workspace) {
         if (current) {
             previous_workspace_name = sstrdup(current->name);
             DLOG("Setting previous_workspace_name = %s\n", previous_workspace_name);
+            workspace_history_add(current->name);
         }
     }
 
@@ -422,15 +566,16 @@ static void _workspace_show(Con *workspace) {
         /* check if this workspace is currently visible */
         if (!workspace_is_visible(old)) {
             LOG("Closing old workspace (%p / %s), it is empty\n", old, old->name);
-            yajl_gen gen = ipc_marshal_workspace_event("empty", old, NULL);
+            /* The workspace is freed below, so the event has to be serialized
+             * now, but only in the flavors somebody is subscribed to. */
+            ipc_encoder *gen = NULL, *compact_gen = NULL;
+            if (ipc_has_event_subscribers("workspace", false))
+                gen = ipc_marshal_workspace_event("empty", old, NULL, false);
+            if (ipc_has_event_subscribers("workspace", true))
+                compact_gen = ipc_marshal_workspace_event("empty", old, NULL, true);
             tree_close(old, DONT_KILL_WINDOW, false, false);
 
-            const unsigned char *payload;
-            ylength length;
-            y(get_buf, &payload, &length);
-            ipc_send_event("workspace", I3_IPC_EVENT_WORKSPACE, (const char *)payload);
-
-            y(free);
+            ipc_send_marshalled_event("workspace", I3_IPC_EVENT_WORKSPACE, gen, compact_gen);
 
             ewmh_update_number_of_desktops();
             ewmh_update_desktop_names();
@@ -266,12 +266,13 @@ bool window_supports_protocol(xcb_window_t window, xcb_atom_t atom) {
 }
 
 /*
- * Kills the given X11 window using WM_DELETE_WINDOW (if supported).
+ * Sends the requests to kill the given X11 window (using WM_DELETE_WINDOW if
+ * supports_delete is true), without flushing the connection.
  *
  */
-void x_window_kill(xcb_window_t window, kill_window_t kill_window) {
+static void x_window_kill_send(xcb_window_t window, kill_window_t kill_window, bool supports_delete) {
     /* if this window does not support WM_DELETE_WINDOW, we kill it the hard way */
-    if (!window_supports_protocol(window, A_WM_DELETE_WINDOW)) {
+    if (!supports_delete) {
         if (kill_window == KILL_WINDOW) {
             LOG("Killing specific window 0x%08x\n", window);
             xcb_destroy_window(conn, window);
@@ -297,10 +298,44 @@ void x_window_kill(xcb_window_t window, kill_window_t kill_window) {
 
     LOG("Sending WM_DELETE to the client\n");
     xcb_send_event(conn, false, window, XCB_EVENT_MASK_NO_EVENT, (char *)ev);
-    xcb_flush(conn);
     free(event);
 }
 
+/*
+ * Kills the given X11 window using WM_DELETE_WINDOW (if supported).
+ *
+ */
+void x_window_kill(xcb_window_t window, kill_window_t kill_window) {
+    x_window_kill_send(window, kill_window, window_supports_protocol(window, A_WM_DELETE_WINDOW));
+    xcb_flush(conn);
+}
+
+/*
+ * Kills the given X11 windows like x_window_kill(), but queries the
+ * WM_PROTOCOLS of all windows in a single round-trip and flushes only once.
+ *
+ */
+void x_window_kill_many(xcb_window_t *windows, int num, kill_window_t kill_window) {
+    xcb_get_property_cookie_t *cookies = smalloc(num * sizeof(xcb_get_property_cookie_t));
+    for (int i = 0; i < num; i++)
+        cookies[i] = xcb_icccm_get_wm_protocols(conn, windows[i], A_WM_PROTOCOLS);
+
+    for (int i = 0; i < num; i++) {
+        xcb_icccm_get_wm_protocols_reply_t protocols;
+        bool supports_delete = false;
+        if (xcb_icccm_get_wm_protocols_reply(conn, cookies[i], &protocols, NULL) == 1) {
+            for (uint32_t j = 0; j < protocols.atoms_len; j++)
+                if (protocols.atoms[j] == A_WM_DELETE_WINDOW)
+                    supports_delete = true;
+            xcb_icccm_get_wm_protocols_reply_wipe(&protocols);
+        }
+        x_window_kill_send(windows[i], kill_window, supports_delete);
+    }
+
+    xcb_flush(conn);
+    free(cookies);
+}
+
 /*
  * Draws the decoration of the given container onto its parent.
  *
@@ -590,7 +625,7 @@ void x_deco_recurse(Con *con) {
     }
 
     if ((con->type != CT_ROOT && con->type != CT_OUTPUT) &&
-        (!leaf || con->mapped))
+        (!leaf || con->mapped || con->prewarmed))
         x_draw_decoration(con);
 }
 
@@ -890,14 +925,20 @@ void x_push_changes(Con *con) {
         pointercookie = xcb_query_pointer(conn, root);
     }
 
+    tree_snapshot_invalidate();
+
     DLOG("-- PUSHING WINDOW STACK --\n");
-    //DLOG("Disabling EnterNotify\n");
-    uint32_t values[1] = {XCB_NONE};
-    CIRCLEQ_FOREACH_REVERSE(state, &state_head, state) {
-        if (state->mapped)
-            xcb_change_window_attributes(conn, state->id, XCB_CW_EVENT_MASK, values);
-    }
-    //DLOG("Done, EnterNotify disabled\n");
+    /* Restacking, moving and mapping windows generates EnterNotify events which
+     * we don’t want. Instead of disabling the event mask of every mapped frame
+     * and enabling it again afterwards (two requests per window, even if only
+     * a few windows changed, e.g. when switching workspaces), we ignore all
+     * EnterNotify events caused by the requests between these two no-ops.
+     * The no-ops themselves are not part of the range: the X server stamps
+     * events caused by the user (e.g. moving the pointer) with the sequence
+     * number of the last request it processed, which is one of the no-ops
+     * when nothing else was sent. */
+    const xcb_void_cookie_t first_cookie = xcb_no_operation(conn);
+    uint32_t values[1];
     bool order_changed = false;
     bool stacking_changed = false;
 
@@ -983,13 +1024,9 @@ void x_push_changes(Con *con) {
         warp_to = NULL;
     }
 
-    //DLOG("Re-enabling EnterNotify\n");
-    values[0] = FRAME_EVENT_MASK;
-    CIRCLEQ_FOREACH_REVERSE(state, &state_head, state) {
-        if (state->mapped)
-            xcb_change_window_attributes(conn, state->id, XCB_CW_EVENT_MASK, values);
-    }
-    //DLOG("Done, EnterNotify re-enabled\n");
+    const xcb_void_cookie_t last_cookie = xcb_no_operation(conn);
+    if (last_cookie.sequence - first_cookie.sequence > 1)
+        add_ignore_event_range(first_cookie.sequence + 1, last_cookie.sequence - 1, XCB_ENTER_NOTIFY);
 
     x_deco_recurse(con);
 
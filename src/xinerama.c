@@ -103,8 +103,10 @@ void xinerama_init(void) {
         if (reply == NULL || !reply->state) {
             DLOG("Xinerama is not active (in your X-Server), disabling.\n");
             disable_randr(conn);
-        } else
+        } else {
             query_screens(conn);
+            randr_update_output_index();
+        }
 
         FREE(reply);
     }
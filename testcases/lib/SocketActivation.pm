@@ -32,6 +32,7 @@ our @EXPORT = qw(activate_i3);
 # configfile: path to the configuration file to use
 # logpath: path to the logfile to which i3 will append
 # cv: an AnyEvent->condvar which will be triggered once i3 is ready
+# enable_signalhandler: do not pass --disable-signalhandler
 #
 sub activate_i3 {
     my %args = @_;
@@ -93,11 +94,13 @@ sub activate_i3 {
         AnyEvent::Util::close_all_fds_except(0, 1, 2, 3);
 
         # Construct the command to launch i3. Use maximum debug level, disable
-        # the interactive signalhandler to make it crash immediately instead.
+        # the interactive signalhandler to make it crash immediately instead
+        # (unless a test needs the crash dialog).
         # Also disable logging to SHM since we redirect the logs anyways.
         # Force Xinerama because we use Xdmx for multi-monitor tests.
-        my $i3cmd = abs_path("../i3") . q| -V -d all --disable-signalhandler| .
-                                        q| --shmlog-size=0 --force-xinerama|;
+        my $i3cmd = abs_path("../i3") . q| -V -d all|;
+        $i3cmd .= q| --disable-signalhandler| unless $args{enable_signalhandler};
+        $i3cmd .= q| --shmlog-size=0 --force-xinerama|;
 
         # For convenience:
         my $outdir = $args{outdir};
@@ -857,6 +857,7 @@ sub launch_with_config {
         restart => $ENV{RESTART},
         cv => $cv,
         dont_create_temp_dir => $args{dont_create_temp_dir},
+        enable_signalhandler => $args{enable_signalhandler},
     );
 
     # force update of the cached socket path in lib/i3test
@@ -0,0 +1,70 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Scaling harness for killing many windows at once (not run by default, see
+# “Scaling harness” in docs/testsuite). Opens many windows and records how
+# long it takes until all of them are closed after killing them by criteria.
+#
+# Parameters (environment variables):
+#   I3_SCALING_WINDOWS  windows to kill (default: 500)
+#   I3_SCALING_ROUNDS   number of times the windows are opened and killed
+#                       (default: 3)
+#   I3_SCALING_RESULTS  file to append the results to (tab-separated)
+use i3test;
+use Time::HiRes qw(time sleep);
+
+my $windows = $ENV{I3_SCALING_WINDOWS} // 500;
+my $rounds = $ENV{I3_SCALING_ROUNDS} // 3;
+
+# Waits until the given workspace has at most $expected children (the killed
+# windows go away asynchronously) and returns the number of children.
+sub wait_for_children {
+    my ($ws, $expected) = @_;
+    my $children;
+    for (1 .. 200) {
+        $children = scalar @{get_ws_content($ws)};
+        last if $children <= $expected;
+        sleep 0.05;
+    }
+    return $children;
+}
+
+my $ms = 0;
+for my $round (1 .. $rounds) {
+    my $ws = fresh_workspace;
+    open_window(wm_class => 'scaling-kill') for (1 .. $windows);
+    open_window;
+
+    my $start = time;
+    cmd '[class="scaling-kill"] kill';
+    my $children = wait_for_children($ws, 1);
+    $ms += (time - $start) * 1000;
+
+    is($children, 1, "round $round: all matching windows closed");
+}
+
+diag(sprintf('%-20s %6d ops %9.1f ms %7.3f ms/op', 'bulk-close', $rounds, $ms, $ms / $rounds));
+
+does_i3_live;
+
+if (defined($ENV{I3_SCALING_RESULTS})) {
+    open(my $results, '>>', $ENV{I3_SCALING_RESULTS})
+        or die "Could not open $ENV{I3_SCALING_RESULTS}: $!";
+    printf $results "%s\t%s\t%d\t%d\t%.1f\n", '-', 'bulk-close', $windows, $rounds, $ms;
+    close($results);
+}
+
+done_testing;
@@ -0,0 +1,59 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Scaling harness for moving windows matched by criteria (not run by default,
+# see “Scaling harness” in docs/testsuite). Opens many windows and records how
+# long moving all of them to another workspace and back takes.
+#
+# Parameters (environment variables):
+#   I3_SCALING_WINDOWS  windows to move (default: 200)
+#   I3_SCALING_ROUNDS   number of times they are moved there and back
+#                       (default: 5)
+#   I3_SCALING_RESULTS  file to append the results to (tab-separated)
+use i3test;
+use Time::HiRes qw(time);
+
+my $windows = $ENV{I3_SCALING_WINDOWS} // 200;
+my $rounds = $ENV{I3_SCALING_ROUNDS} // 5;
+
+my $tmp = fresh_workspace;
+my $target = get_unused_workspace;
+
+open_window(wm_class => 'scaling-move') for (1 .. $windows);
+
+my $ms = 0;
+for my $round (1 .. $rounds) {
+    my $start = time;
+    cmd qq|[class="scaling-move"] move to workspace $target|;
+    cmd qq|[class="scaling-move"] move to workspace $tmp|;
+    $ms += (time - $start) * 1000;
+
+    is(scalar @{get_ws_content($tmp)}, $windows, "round $round: all windows moved there and back");
+}
+
+my $ops = $rounds * 2;
+diag(sprintf('%-20s %6d ops %9.1f ms %7.3f ms/op', 'move-batch', $ops, $ms, $ms / $ops));
+
+does_i3_live;
+
+if (defined($ENV{I3_SCALING_RESULTS})) {
+    open(my $results, '>>', $ENV{I3_SCALING_RESULTS})
+        or die "Could not open $ENV{I3_SCALING_RESULTS}: $!";
+    printf $results "%s\t%s\t%d\t%d\t%.1f\n", '-', 'move-batch', $windows, $ops, $ms;
+    close($results);
+}
+
+done_testing;
@@ -0,0 +1,159 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Scaling harness for output-heavy code paths (not run by default, see
+# “Scaling harness” in docs/testsuite). Starts i3 on a grid of fake outputs,
+# populates each output with windows created by a separate X11 client and
+# records how long scripted workspace switching, moving containers across
+# outputs and focus traversal take.
+#
+# Parameters (environment variables):
+#   I3_SCALING_GRID     output grid, colsxrows@wxh (default: 4x4@3840x2160)
+#   I3_SCALING_WINDOWS  windows per output (default: 10)
+#   I3_SCALING_ROUNDS   repetitions of each scenario (default: 20)
+#   I3_SCALING_RESULTS  file to append the results to (tab-separated)
+use i3test i3_autostart => 0;
+use X11::XCB qw(:all);
+use Time::HiRes qw(time sleep);
+use POSIX ();
+
+my $grid = $ENV{I3_SCALING_GRID} // '4x4@3840x2160';
+my $windows = $ENV{I3_SCALING_WINDOWS} // 10;
+my $rounds = $ENV{I3_SCALING_ROUNDS} // 20;
+
+my ($cols, $rows) = ($grid =~ /^(\d+)x(\d+)@\d+x\d+$/)
+    or BAIL_OUT("I3_SCALING_GRID must be colsxrows\@wxh, not $grid");
+my $num_outputs = $cols * $rows;
+
+# One workspace per output, and the windows of the companion client are
+# assigned to them by their class.
+my $config = <<EOT;
+# i3 config file (v4)
+font -misc-fixed-medium-r-normal--13-120-75-75-C-70-iso10646-1
+
+fake-outputs $grid
+EOT
+for my $n (1 .. $num_outputs) {
+    $config .= "workspace $n output fake-" . ($n - 1) . "\n";
+    $config .= qq|assign [class="^scaling-$n\$"] $n\n|;
+}
+
+my $pid = launch_with_config($config);
+my $i3 = i3(get_socket_path());
+
+################################################################################
+# Populate the outputs from a companion client. It runs in a separate process
+# with its own X11 connection and keeps its windows open until we close the
+# pipe.
+################################################################################
+
+pipe(my $done_r, my $done_w) or die "pipe: $!";
+my $companion = fork;
+die "fork: $!" unless defined($companion);
+if ($companion == 0) {
+    close($done_w);
+    my $conn = X11::XCB::Connection->new(display => $ENV{DISPLAY});
+    my @keep;
+    for my $n (1 .. $num_outputs) {
+        for my $i (1 .. $windows) {
+            my $window = $conn->root->create_child(
+                class => WINDOW_CLASS_INPUT_OUTPUT,
+                rect => [ 0, 0, 30, 30 ],
+                background_color => '#c0c0c0',
+                wm_class => "scaling-$n",
+                name => "scaling $n/$i",
+            );
+            $window->map;
+            push @keep, $window;
+        }
+    }
+    $conn->flush;
+    # Block until the harness is done.
+    <$done_r>;
+    POSIX::_exit(0);
+}
+close($done_r);
+
+sub count_windows {
+    my ($con) = @_;
+    my $count = (defined($con->{window}) ? 1 : 0);
+    $count += count_windows($_) for (@{$con->{nodes}}, @{$con->{floating_nodes}});
+    return $count;
+}
+
+my $expected = $num_outputs * $windows;
+my $start = time;
+my $managed = 0;
+while (time - $start < 60) {
+    $managed = count_windows($i3->get_tree->recv);
+    last if $managed >= $expected;
+    sleep 0.1;
+}
+is($managed, $expected, "companion client created $expected windows");
+
+my @results;
+
+# Runs the given commands in order, $rounds times, and records the duration.
+sub measure {
+    my ($scenario, @commands) = @_;
+    my $ops = 0;
+    my $start = time;
+    for (1 .. $rounds) {
+        for my $command (@commands) {
+            cmd $command;
+            $ops++;
+        }
+    }
+    my $ms = (time - $start) * 1000;
+    push @results, [ $scenario, $ops, $ms ];
+    diag(sprintf('%-20s %6d ops %9.1f ms %7.3f ms/op', $scenario, $ops, $ms, $ms / $ops));
+}
+
+################################################################################
+# Scenarios
+################################################################################
+
+measure('workspace-switch', map { "workspace $_" } (1 .. $num_outputs));
+
+cmd 'workspace 1';
+measure('focus-output', ('focus output right') x $cols, ('focus output down') x $rows,
+        ('focus output left') x $cols, ('focus output up') x $rows);
+
+cmd 'workspace 1';
+measure('focus-traversal', ('focus right') x $windows, ('focus left') x $windows);
+
+cmd 'workspace 1';
+measure('move-to-output', ('move container to output right', 'focus output right') x $cols,
+        ('move container to output down', 'focus output down') x $rows);
+
+does_i3_live;
+
+if (defined($ENV{I3_SCALING_RESULTS})) {
+    open(my $fh, '>>', $ENV{I3_SCALING_RESULTS})
+        or die "Could not open $ENV{I3_SCALING_RESULTS}: $!";
+    for my $result (@results) {
+        my ($scenario, $ops, $ms) = @$result;
+        printf $fh "%s\t%s\t%d\t%d\t%.1f\n", $grid, $scenario, $windows, $ops, $ms;
+    }
+    close($fh);
+}
+
+close($done_w);
+waitpid($companion, 0);
+
+exit_gracefully($pid);
+
+done_testing;
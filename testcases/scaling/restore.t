@@ -0,0 +1,85 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Scaling harness for restoring layouts (not run by default, see “Scaling
+# harness” in docs/testsuite). Appends a layout with many placeholder windows
+# to a fresh workspace and records how long opening and drawing the
+# placeholders takes.
+#
+# Parameters (environment variables):
+#   I3_SCALING_WINDOWS  placeholder windows per layout (default: 100)
+#   I3_SCALING_ROUNDS   number of layouts to restore (default: 10)
+#   I3_SCALING_RESULTS  file to append the results to (tab-separated)
+use i3test;
+use File::Temp qw(tempfile);
+use IO::Handle;
+use Time::HiRes qw(time);
+
+my $windows = $ENV{I3_SCALING_WINDOWS} // 100;
+my $rounds = $ENV{I3_SCALING_ROUNDS} // 10;
+
+# The placeholders are arranged in columns of (up to) ten windows each.
+my @columns;
+for (my $n = 0; $n < $windows; $n += 10) {
+    my @leaves;
+    for my $i ($n .. ($n + 9 < $windows ? $n + 9 : $windows - 1)) {
+        push @leaves, qq|{ "name": "placeholder $i", "swallows": [ { "class": "^scaling-restore-$i\$" } ] }|;
+    }
+    push @columns, qq|{ "layout": "splitv", "nodes": [ | . join(', ', @leaves) . ' ] }';
+}
+
+my ($fh, $filename) = tempfile(UNLINK => 1);
+print $fh qq|{ "layout": "splith", "nodes": [ | . join(",\n", @columns) . " ] }\n";
+$fh->flush;
+
+sub count_leaves {
+    my ($con) = @_;
+    my @children = (@{$con->{nodes}}, @{$con->{floating_nodes}});
+    return 1 if @children == 0;
+    my $count = 0;
+    $count += count_leaves($_) for @children;
+    return $count;
+}
+
+my $ms = 0;
+for my $round (1 .. $rounds) {
+    my $ws = fresh_workspace;
+
+    my $start = time;
+    cmd "append_layout $filename";
+    # Wait until i3 (and thereby the placeholder connection, which is handled
+    # in the same event loop) processed the resulting ConfigureNotify events.
+    sync_with_i3;
+    $ms += (time - $start) * 1000;
+
+    my $ws_con = get_ws($ws);
+    is(count_leaves($ws_con), $windows, "round $round: $windows placeholders restored");
+}
+
+diag(sprintf('%-20s %6d ops %9.1f ms %7.3f ms/op', 'restore-layout', $rounds, $ms, $ms / $rounds));
+
+does_i3_live;
+
+if (defined($ENV{I3_SCALING_RESULTS})) {
+    open(my $results, '>>', $ENV{I3_SCALING_RESULTS})
+        or die "Could not open $ENV{I3_SCALING_RESULTS}: $!";
+    printf $results "%s\t%s\t%d\t%d\t%.1f\n", '-', 'restore-layout', $windows, $rounds, $ms;
+    close($results);
+}
+
+close($fh);
+
+done_testing;
@@ -0,0 +1,63 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Scaling harness for switching between two populated workspaces (not run by
+# default, see “Scaling harness” in docs/testsuite). Opens the same number of
+# windows on two workspaces and records how long switching back and forth
+# takes. Every switch unmaps all windows of one workspace and maps all windows
+# of the other one; the target is less than a millisecond per switch with 50
+# windows on each workspace.
+#
+# Parameters (environment variables):
+#   I3_SCALING_WINDOWS  windows per workspace (default: 50)
+#   I3_SCALING_ROUNDS   number of times to switch there and back (default: 100)
+#   I3_SCALING_RESULTS  file to append the results to (tab-separated)
+use i3test;
+use Time::HiRes qw(time);
+
+my $windows = $ENV{I3_SCALING_WINDOWS} // 50;
+my $rounds = $ENV{I3_SCALING_ROUNDS} // 100;
+
+my $first = fresh_workspace;
+open_window for (1 .. $windows);
+my $second = fresh_workspace;
+open_window for (1 .. $windows);
+
+is(scalar @{get_ws_content($first)}, $windows, "$windows windows on the first workspace");
+is(scalar @{get_ws_content($second)}, $windows, "$windows windows on the second workspace");
+
+my $ms = 0;
+for my $round (1 .. $rounds) {
+    my $start = time;
+    cmd "workspace $first";
+    cmd "workspace $second";
+    $ms += (time - $start) * 1000;
+}
+is(focused_ws, $second, 'switched back to the second workspace');
+
+my $ops = $rounds * 2;
+diag(sprintf('%-20s %6d ops %9.1f ms %7.3f ms/op', 'workspace-switch', $ops, $ms, $ms / $ops));
+
+does_i3_live;
+
+if (defined($ENV{I3_SCALING_RESULTS})) {
+    open(my $results, '>>', $ENV{I3_SCALING_RESULTS})
+        or die "Could not open $ENV{I3_SCALING_RESULTS}: $!";
+    printf $results "%s\t%s\t%d\t%d\t%.1f\n", '-', 'workspace-switch', $windows, $ops, $ms;
+    close($results);
+}
+
+done_testing;
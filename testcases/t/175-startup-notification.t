@@ -23,7 +23,7 @@ use File::Temp qw(:POSIX);
 
 SKIP: {
 
-    skip "X11::XCB too old (need >= 0.07)", 24 if $X11::XCB::VERSION < 0.07;
+    skip "X11::XCB too old (need >= 0.07)", 29 if $X11::XCB::VERSION < 0.07;
 
 use ExtUtils::PkgConfig;
 
@@ -214,6 +214,63 @@ close($fh);
 unlink($tmp);
 
 is($startup_id, '', 'startup_id empty');
+
+######################################################################
+# 5) moving a window which has its own _NET_STARTUP_ID deletes only
+# its own startup sequence, not the one of its leader
+######################################################################
+
+# Starts a new process via i3 like in 1) and sets up a launchee context
+# for its startup id.
+sub start_sequence {
+    mkfifo($tmp, 0600) or BAIL_OUT "Could not create FIFO in $tmp";
+
+    cmd qq|exec echo \$DESKTOP_STARTUP_ID >$tmp|;
+
+    open($fh, '<', $tmp);
+    chomp(my $id = <$fh>);
+    close($fh);
+
+    unlink($tmp);
+
+    isnt($id, '', 'startup_id not empty');
+    $ENV{DESKTOP_STARTUP_ID} = $id;
+    init_ctx($x->get_xcb_conn());
+}
+
+my $leader_ws = fresh_workspace;
+start_sequence();
+my $own_leader = open_window({ dont_map => 1 });
+mark_window($own_leader->id);
+
+my $own_ws = fresh_workspace;
+start_sequence();
+
+my $target_ws = fresh_workspace;
+my $own = open_window({ dont_map => 1, client_leader => $own_leader });
+mark_window($own->id);
+$own->map;
+sync_with_i3;
+
+is_num_children($own_ws, 1, 'window with its own startup id is placed by it');
+
+cmd "workspace $own_ws";
+cmd "move workspace $target_ws";
+
+my $current_ws = fresh_workspace;
+
+$win = open_window({ dont_map => 1, client_leader => $own_leader });
+$win->map;
+sync_with_i3;
+
+is_num_children($leader_ws, 1, 'startup sequence of the leader still exists');
+
+$win = open_window({ dont_map => 1 });
+mark_window($win->id);
+$win->map;
+sync_with_i3;
+
+is_num_children($current_ws, 1, 'startup sequence of the moved window was deleted');
 }
 
 done_testing;
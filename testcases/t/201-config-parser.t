@@ -71,16 +71,34 @@ exec_always --no-startup-id /tmp/bar.sh
 EOT
 
 $expected = <<'EOT';
-cfg_exec(exec, (null), geeqie)
-cfg_exec(exec, --no-startup-id, /tmp/foo.sh)
-cfg_exec(exec_always, (null), firefox)
-cfg_exec(exec_always, --no-startup-id, /tmp/bar.sh)
+cfg_exec(exec, (null), 0, (null), geeqie)
+cfg_exec(exec, --no-startup-id, 0, (null), /tmp/foo.sh)
+cfg_exec(exec_always, (null), 0, (null), firefox)
+cfg_exec(exec_always, --no-startup-id, 0, (null), /tmp/bar.sh)
 EOT
 
 is(parser_calls($config),
    $expected,
    'exec okay');
 
+$config = <<'EOT';
+exec_concurrency 2
+exec --priority 10 firefox
+exec --wait-for-class Firefox --no-startup-id /tmp/foo.sh
+exec_always --no-startup-id --priority 5 --wait-for-class Thunderbird /tmp/bar.sh
+EOT
+
+$expected = <<'EOT';
+cfg_exec_concurrency(2)
+cfg_exec(exec, (null), 10, (null), firefox)
+cfg_exec(exec, --no-startup-id, 0, Firefox, /tmp/foo.sh)
+cfg_exec(exec_always, --no-startup-id, 5, Thunderbird, /tmp/bar.sh)
+EOT
+
+is(parser_calls($config),
+   $expected,
+   'exec with priority and wait-for-class okay');
+
 ################################################################################
 # for_window
 ################################################################################
@@ -327,6 +345,36 @@ is(parser_calls($config),
    $expected,
    'mouse_warping ok');
 
+################################################################################
+# directional_focus
+################################################################################
+
+$config = <<'EOT';
+directional_focus geometric
+directional_focus tree
+EOT
+
+$expected = <<'EOT';
+cfg_directional_focus(geometric)
+cfg_directional_focus(tree)
+EOT
+
+is(parser_calls($config),
+   $expected,
+   'directional_focus ok');
+
+################################################################################
+# workspace_prewarm
+################################################################################
+
+is(parser_calls('workspace_prewarm 64'),
+   "cfg_workspace_prewarm(64)\n",
+   'workspace_prewarm ok');
+
+is(parser_calls('workspace_prewarm 32 mb'),
+   "cfg_workspace_prewarm(32)\n",
+   'workspace_prewarm with unit ok');
+
 ################################################################################
 # force_display_urgency_hint
 ################################################################################
@@ -433,7 +481,7 @@ client.focused          #4c7899 #285577 #ffffff #2e9ef4
 EOT
 
 my $expected_all_tokens = <<'EOT';
-ERROR: CONFIG: Expected one of these tokens: <end>, '#', 'set', 'bindsym', 'bindcode', 'bind', 'bar', 'font', 'mode', 'floating_minimum_size', 'floating_maximum_size', 'floating_modifier', 'default_orientation', 'workspace_layout', 'new_window', 'new_float', 'hide_edge_borders', 'for_window', 'assign', 'focus_follows_mouse', 'mouse_warping', 'force_focus_wrapping', 'force_xinerama', 'force-xinerama', 'workspace_auto_back_and_forth', 'fake_outputs', 'fake-outputs', 'force_display_urgency_hint', 'workspace', 'ipc_socket', 'ipc-socket', 'restart_state', 'popup_during_fullscreen', 'exec_always', 'exec', 'client.background', 'client.focused_inactive', 'client.focused', 'client.unfocused', 'client.urgent', 'client.placeholder'
+ERROR: CONFIG: Expected one of these tokens: <end>, '#', 'set', 'bindsym', 'bindcode', 'bind', 'bar', 'font', 'mode', 'floating_minimum_size', 'floating_maximum_size', 'floating_modifier', 'default_orientation', 'workspace_layout', 'new_window', 'new_float', 'hide_edge_borders', 'for_window', 'assign', 'focus_follows_mouse', 'mouse_warping', 'force_focus_wrapping', 'directional_focus', 'force_xinerama', 'force-xinerama', 'workspace_auto_back_and_forth', 'workspace_prewarm', 'fake_outputs', 'fake-outputs', 'force_display_urgency_hint', 'workspace', 'ipc_socket', 'ipc-socket', 'restart_state', 'popup_during_fullscreen', 'exec_concurrency', 'fast_start', 'exec_always', 'exec', 'client.background', 'client.focused_inactive', 'client.focused', 'client.unfocused', 'client.urgent', 'client.placeholder'
 EOT
 
 my $expected_end = <<'EOT';
@@ -0,0 +1,130 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that clients which subscribe to the compact flavor of the workspace
+# and window events only get ids, names and geometry, that the details can be
+# requested with GET_TREE afterwards, and that clients which subscribe to both
+# flavors get both payloads.
+use i3test;
+
+my $i3 = i3(get_socket_path());
+$i3->connect()->recv;
+
+my $cv;
+my $t;
+
+sub reset_test {
+    $cv = AE::cv;
+    $t = AE::timer(0.5, 0, sub { $cv->send(0); });
+}
+
+reset_test;
+
+# Register the callbacks with AnyEvent::I3, then switch the subscription to
+# the compact flavor (AnyEvent::I3 only knows the plain event names).
+$i3->subscribe({
+        workspace => sub {
+            my ($e) = @_;
+            $cv->send($e) if $e->{change} eq 'focus';
+        },
+        window => sub {
+            my ($e) = @_;
+            $cv->send($e) if $e->{change} eq 'new';
+        },
+    })->recv;
+
+my $reply = $i3->message(2, [ 'workspace:compact', 'window:compact' ])->recv;
+ok($reply->{success}, 'subscribing to the compact flavor succeeded');
+
+################################################################################
+# workspace focus event
+################################################################################
+
+my $old_ws = fresh_workspace;
+my $new_ws = get_unused_workspace;
+
+reset_test;
+cmd "workspace $new_ws";
+my $e = $cv->recv;
+
+ok($e, 'workspace focus event received');
+is($e->{current}->{name}, $new_ws, 'current workspace name is included');
+is($e->{old}->{name}, $old_ws, 'old workspace name is included');
+ok(exists $e->{current}->{rect}, 'current workspace rect is included');
+ok(!exists $e->{current}->{nodes}, 'current workspace nodes are not included');
+ok(!exists $e->{current}->{layout}, 'current workspace layout is not included');
+
+################################################################################
+# window new event
+################################################################################
+
+reset_test;
+my $window = open_window;
+$e = $cv->recv;
+
+ok($e, 'window new event received');
+is($e->{container}->{window}, $window->{id}, 'window id is included');
+ok(!exists $e->{container}->{window_properties}, 'window properties are not included');
+
+################################################################################
+# requesting details with GET_TREE
+################################################################################
+
+my $con = $i3->message(4, $e->{container}->{id})->recv;
+is($con->{id}, $e->{container}->{id}, 'GET_TREE returns the requested container');
+is($con->{window}, $window->{id}, 'GET_TREE returns the window of the container');
+ok(exists $con->{window_properties}, 'GET_TREE includes the window properties');
+
+$con = $i3->message(4, '1')->recv;
+ok(!defined($con->{id}), 'GET_TREE with an unknown container id returns a null id');
+
+################################################################################
+# subscribing to both flavors
+################################################################################
+
+my $both = i3(get_socket_path());
+$both->connect()->recv;
+
+my @events;
+my $both_cv;
+my $empty_ws;
+$both->subscribe({
+        workspace => sub {
+            my ($e) = @_;
+            return unless defined($empty_ws);
+            push @events, $e if ($e->{change} eq 'focus' && $e->{current}->{name} eq $old_ws) ||
+                                ($e->{change} eq 'empty' && $e->{current}->{name} eq $empty_ws);
+            $both_cv->send(1) if @events == 4;
+        },
+    })->recv;
+$reply = $both->message(2, [ 'workspace:compact' ])->recv;
+ok($reply->{success}, 'subscribing to the compact flavor as well succeeded');
+
+# Switching away from an empty workspace emits a focus and an empty event.
+$empty_ws = fresh_workspace;
+$both_cv = AE::cv;
+my $timeout = AE::timer(0.5, 0, sub { $both_cv->send(0); });
+cmd "workspace $old_ws";
+ok($both_cv->recv, 'both flavors of the focus and empty events received');
+
+for my $change (qw(focus empty)) {
+    my @flavors = grep { $_->{change} eq $change } @events;
+    is(scalar @flavors, 2, "$change event received twice");
+    is(scalar grep({ exists $_->{current}->{nodes} } @flavors), 1, "full $change event received");
+    is(scalar grep({ !exists $_->{current}->{nodes} } @flavors), 1, "compact $change event received");
+}
+
+done_testing;
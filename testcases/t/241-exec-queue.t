@@ -0,0 +1,56 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that exec lines are started in the order of their priority, that
+# exec_concurrency limits the number of startups in progress and that the
+# state of the exec queue is reported by GET_STARTUP.
+use i3test i3_autostart => 0;
+
+my $config = <<EOT;
+# i3 config file (v4)
+font -misc-fixed-medium-r-normal--13-120-75-75-C-70-iso10646-1
+
+exec_concurrency 1
+
+exec sleep 30
+exec --priority 10 sleep 31
+exec --no-startup-id --wait-for-class i3-test-nonexistent true
+EOT
+
+my $pid = launch_with_config($config);
+
+my $i3 = i3(get_socket_path());
+$i3->connect()->recv;
+
+my $reply = $i3->message(8)->recv;
+my @autostarts = @{$reply->{autostarts}};
+
+is(scalar @autostarts, 3, 'all exec lines are reported');
+
+is($autostarts[0]->{command}, 'sleep 31', 'higher priority is started first');
+is($autostarts[0]->{priority}, 10, 'priority is reported');
+is($autostarts[0]->{state}, 'running', 'first command is running');
+ok(!defined($autostarts[0]->{map_latency}), 'no map latency without a window');
+
+is($autostarts[1]->{command}, 'sleep 30', 'lower priority is started later');
+is($autostarts[1]->{state}, 'queued', 'second command is queued (exec_concurrency 1)');
+
+is($autostarts[2]->{wait_for_class}, 'i3-test-nonexistent', 'wait_for_class is reported');
+is($autostarts[2]->{state}, 'queued', 'command waiting for a class is queued');
+
+exit_gracefully($pid);
+
+done_testing;
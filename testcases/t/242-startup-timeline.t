@@ -0,0 +1,83 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that the startup phases are reported by GET_STARTUP and that with
+# fast_start, exec lines are only started after the first frame.
+use i3test i3_autostart => 0;
+
+sub get_phases {
+    my $i3 = i3(get_socket_path());
+    $i3->connect()->recv;
+
+    my $reply = $i3->message(8)->recv;
+    return { map { ($_->{name} => $_) } @{$reply->{phases}} };
+}
+
+# first_frame is recorded once i3 is idle for the first time, and with
+# fast_start the exec lines are started after that, so the request might be
+# answered before these phases exist.
+sub wait_for_phases {
+    my @names = @_;
+    my $phases;
+    for (1 .. 100) {
+        $phases = get_phases;
+        return $phases unless grep { !exists $phases->{$_} } @names;
+        sync_with_i3;
+    }
+    return $phases;
+}
+
+my $config = <<EOT;
+# i3 config file (v4)
+font -misc-fixed-medium-r-normal--13-120-75-75-C-70-iso10646-1
+
+exec --no-startup-id true
+EOT
+
+my $pid = launch_with_config($config);
+
+my $phases = wait_for_phases(qw(first_frame autostart));
+for my $name (qw(x_connect config font tree_init randr_init tree_render manage_existing_windows first_frame autostart)) {
+    ok(exists $phases->{$name}, "phase $name is reported");
+}
+ok($phases->{config}->{start} <= $phases->{font}->{start}, 'font is loaded while parsing the config');
+cmp_ok($phases->{autostart}->{start}, '<', $phases->{first_frame}->{start},
+       'without fast_start, exec lines are started before the first frame');
+
+exit_gracefully($pid);
+
+################################################################################
+# fast_start defers the exec lines
+################################################################################
+
+$config = <<EOT;
+# i3 config file (v4)
+font -misc-fixed-medium-r-normal--13-120-75-75-C-70-iso10646-1
+
+fast_start yes
+exec --no-startup-id true
+EOT
+
+$pid = launch_with_config($config);
+
+$phases = wait_for_phases(qw(first_frame autostart));
+ok(exists $phases->{$_}, "phase $_ is reported with fast_start") for qw(first_frame autostart);
+cmp_ok($phases->{autostart}->{start}, '>=', $phases->{first_frame}->{start},
+       'with fast_start, exec lines are started after the first frame');
+
+exit_gracefully($pid);
+
+done_testing;
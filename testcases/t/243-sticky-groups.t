@@ -0,0 +1,74 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that the window of a sticky group follows the user to the group’s
+# container on the workspace which is switched to.
+use i3test;
+use File::Temp qw(tempfile);
+use IO::Handle;
+
+sub append_sticky_layout {
+    my ($class) = @_;
+
+    my ($fh, $filename) = tempfile(UNLINK => 1);
+    print $fh <<EOT;
+{
+    "layout": "splith",
+    "nodes": [
+        {
+            "sticky_group": "sticky_test",
+            "swallows": [
+                {
+                    "class": "^$class\$"
+                }
+            ]
+        }
+    ]
+}
+EOT
+    $fh->flush;
+    cmd "append_layout $filename";
+    close($fh);
+}
+
+my $ws1 = fresh_workspace;
+append_sticky_layout('sticky_class');
+my $window = open_window(wm_class => 'sticky_class');
+
+my @content = @{get_ws_content($ws1)};
+is($content[0]->{nodes}->[0]->{window}, $window->id, 'window swallowed on the first workspace');
+
+my $ws2 = fresh_workspace;
+append_sticky_layout('sticky_never_matches');
+
+@content = @{get_ws_content($ws2)};
+is(@{$content[0]->{nodes}}, 1, 'sticky container on the second workspace');
+
+cmd "workspace $ws1";
+cmd "workspace $ws2";
+
+@content = @{get_ws_content($ws2)};
+is($content[0]->{nodes}->[0]->{window}, $window->id, 'window moved to the second workspace');
+
+@content = @{get_ws_content($ws1)};
+ok(!defined($content[0]->{nodes}->[0]->{window}), 'window no longer on the first workspace');
+
+cmd "workspace $ws1";
+
+@content = @{get_ws_content($ws1)};
+is($content[0]->{nodes}->[0]->{window}, $window->id, 'window moved back to the first workspace');
+
+done_testing;
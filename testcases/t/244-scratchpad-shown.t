@@ -0,0 +1,85 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that 'scratchpad show' finds shown scratchpad windows on other
+# workspaces via the list of shown scratchpad windows, and that this list
+# stays correct when scratchpad windows are closed, made tiling or when i3
+# is restarted.
+use i3test;
+
+################################################################################
+# 1: a scratchpad window shown on another workspace is moved to the current
+# workspace.
+################################################################################
+
+my $tmp = fresh_workspace;
+my $scratch = open_window;
+cmd 'move scratchpad';
+cmd 'scratchpad show';
+
+is(scalar @{get_ws($tmp)->{floating_nodes}}, 1, 'scratchpad window shown');
+
+my $other = fresh_workspace;
+cmd 'scratchpad show';
+
+is(scalar @{get_ws($tmp)->{floating_nodes}}, 0, 'scratchpad window moved away');
+is(scalar @{get_ws($other)->{floating_nodes}}, 1, 'scratchpad window moved here');
+
+################################################################################
+# 2: the shown scratchpad window survives an in-place restart.
+################################################################################
+
+cmd 'restart';
+does_i3_live;
+
+$tmp = fresh_workspace;
+cmd 'scratchpad show';
+
+is(scalar @{get_ws($other)->{floating_nodes}}, 0, 'scratchpad window moved away after restart');
+is(scalar @{get_ws($tmp)->{floating_nodes}}, 1, 'scratchpad window moved here after restart');
+
+################################################################################
+# 3: a scratchpad window which was made tiling is no longer shown.
+################################################################################
+
+cmd 'floating disable';
+
+$other = fresh_workspace;
+cmd 'scratchpad show';
+
+is(scalar @{get_ws($tmp)->{nodes}}, 1, 'tiling window stays');
+is(scalar @{get_ws($other)->{floating_nodes}}, 0, 'tiling window not moved');
+
+################################################################################
+# 4: closing a shown scratchpad window removes it from the list.
+################################################################################
+
+my $second = open_window;
+cmd 'move scratchpad';
+cmd 'scratchpad show';
+
+is(scalar @{get_ws($other)->{floating_nodes}}, 1, 'second scratchpad window shown');
+
+cmd 'kill';
+wait_for_unmap($second);
+
+$tmp = fresh_workspace;
+cmd 'scratchpad show';
+does_i3_live;
+
+is(scalar @{get_ws($tmp)->{floating_nodes}}, 0, 'closed scratchpad window not shown');
+
+done_testing;
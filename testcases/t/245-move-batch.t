@@ -0,0 +1,95 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that moving windows matched by criteria to another workspace moves
+# all of them, keeps the focus on the current workspace, does not switch
+# workspaces for each window, still sends one window::move event per window
+# and renders the tree once. See scaling/move-batch.t for timings with many
+# windows.
+use i3test;
+use X11::XCB qw(:all);
+
+my $num = 5;
+
+# Counts the ConfigureNotify events which the given window received until i3
+# answers a sync request. i3 configures the window whenever a render changes
+# its size.
+sub count_resizes {
+    my ($window) = @_;
+    my $resizes = 0;
+    my $rnd = sync_with_i3(dont_wait_for_event => 1);
+    wait_for_event 4, sub {
+        my ($event) = @_;
+        $resizes++ if $event->{response_type} == CONFIGURE_NOTIFY && $event->{window} == $window->id;
+        return 0 unless $event->{response_type} == 161;
+        my ($win, $reply_rnd) = unpack "LL", $event->{data};
+        return ($reply_rnd == $rnd);
+    };
+    return $resizes;
+}
+
+my $i3 = i3(get_socket_path());
+$i3->connect()->recv;
+
+my $tmp = fresh_workspace;
+my $target = get_unused_workspace;
+
+my $focus_events = 0;
+my $move_events = 0;
+my $cv;
+
+$i3->subscribe({
+        workspace => sub {
+            my ($e) = @_;
+            $focus_events++ if $e->{change} eq 'focus';
+        },
+        window => sub {
+            my ($e) = @_;
+            return unless $e->{change} eq 'move';
+            $move_events++;
+            $cv->send(1) if $move_events == $num;
+        },
+    })->recv;
+
+open_window(wm_class => 'batch') for (1 .. $num);
+my $other = open_window;
+sync_with_i3;
+
+$cv = AE::cv;
+my $t = AE::timer(10, 0, sub { $cv->send(0); });
+
+cmd qq|[class="batch"] move to workspace $target|;
+is(count_resizes($other), 1, 'remaining window resized once, the tree was rendered once');
+
+ok($cv->recv, 'one window::move event per window');
+is(scalar @{get_ws_content($target)}, $num, 'all windows moved');
+is(scalar @{get_ws_content($tmp)}, 1, 'other window stays');
+is($focus_events, 0, 'no workspace focus events');
+is($x->input_focus, $other->id, 'focus stays on the current workspace');
+
+################################################################################
+# Moving the windows back to the current workspace focuses them, just like
+# moving a single window does.
+################################################################################
+
+cmd qq|[class="batch"] move to workspace $tmp|;
+
+is(scalar @{get_ws_content($tmp)}, $num + 1, 'all windows moved back');
+ok(!workspace_exists($target), 'target workspace closed');
+is(get_ws($tmp)->{focused}, 1, 'current workspace still focused');
+isnt($x->input_focus, $other->id, 'a moved window is focused');
+
+done_testing;
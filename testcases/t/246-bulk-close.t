@@ -0,0 +1,90 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that killing several windows at once (by criteria or by killing a
+# workspace) closes all of them and renders the tree once, after the last one
+# went away. See scaling/bulk-close.t for timings with many windows.
+use i3test;
+use X11::XCB qw(:all);
+use Time::HiRes qw(sleep);
+
+my $num = 5;
+
+# Waits until the given workspace has at most $expected children (the killed
+# windows go away asynchronously) and returns the number of children. Only
+# uses IPC, so that no X11 events are consumed.
+sub wait_for_children {
+    my ($ws, $expected) = @_;
+    my $children;
+    for (1 .. 200) {
+        $children = scalar @{get_ws_content($ws)};
+        last if $children <= $expected;
+        sleep 0.05;
+    }
+    return $children;
+}
+
+# Counts the ConfigureNotify events which the given window received until i3
+# answers a sync request. i3 configures the window whenever a render changes
+# its size.
+sub count_resizes {
+    my ($window) = @_;
+    my $resizes = 0;
+    my $rnd = sync_with_i3(dont_wait_for_event => 1);
+    wait_for_event 4, sub {
+        my ($event) = @_;
+        $resizes++ if $event->{response_type} == CONFIGURE_NOTIFY && $event->{window} == $window->id;
+        return 0 unless $event->{response_type} == 161;
+        my ($win, $reply_rnd) = unpack "LL", $event->{data};
+        return ($reply_rnd == $rnd);
+    };
+    return $resizes;
+}
+
+################################################################################
+# 1: kill by criteria
+################################################################################
+
+my $tmp = fresh_workspace;
+
+open_window(wm_class => 'bulk') for (1 .. $num);
+my $other = open_window;
+sync_with_i3;
+
+cmd '[class="bulk"] kill';
+is(wait_for_children($tmp, 1), 1, 'all matching windows closed');
+is(count_resizes($other), 1, 'remaining window resized once, the tree was rendered once');
+
+my $ws = get_ws($tmp);
+is($ws->{nodes}->[0]->{rect}->{width}, $ws->{rect}->{width},
+   'remaining window uses the whole width');
+is($x->input_focus, $other->id, 'remaining window focused');
+
+################################################################################
+# 2: kill all windows on the focused workspace
+################################################################################
+
+$tmp = fresh_workspace;
+
+open_window for (1 .. $num);
+
+cmd 'focus parent';
+cmd 'kill';
+is(wait_for_children($tmp, 0), 0, 'all windows on the workspace closed');
+
+does_i3_live;
+
+done_testing;
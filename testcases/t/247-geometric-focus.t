@@ -0,0 +1,114 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that 'directional_focus geometric' focuses the nearest container in
+# the given direction instead of the most recently focused one in the
+# neighboring subtree.
+#
+use i3test i3_autostart => 0;
+
+# Sets up the following layout on a fresh workspace:
+#   +---+---+
+#   | A | C |
+#   +---+---+
+#   | B | D |
+#   +---+---+
+# in which A is the most recently focused window of the left column.
+sub grid_layout {
+    my $tmp = fresh_workspace;
+
+    my $A = open_window;
+    cmd 'split v';
+    my $B = open_window;
+    cmd 'focus parent';
+    my $C = open_window;
+    cmd 'split v';
+    my $D = open_window;
+
+    cmd '[id="' . $A->id . '"] focus';
+    cmd '[id="' . $D->id . '"] focus';
+    is($x->input_focus, $D->id, 'D focused');
+
+    return ($A, $B, $C, $D);
+}
+
+#####################################################################
+# 1: without directional_focus, the tree is walked
+#####################################################################
+
+my $config = <<EOT;
+# i3 config file (v4)
+font -misc-fixed-medium-r-normal--13-120-75-75-C-70-iso10646-1
+EOT
+
+my $pid = launch_with_config($config);
+
+my ($A, $B, $C, $D) = grid_layout;
+
+cmd 'focus left';
+is($x->input_focus, $A->id, 'A focused (most recently focused in the left column)');
+
+exit_gracefully($pid);
+
+#####################################################################
+# 2: with directional_focus geometric, the nearest window is focused
+#####################################################################
+
+$config = <<EOT;
+# i3 config file (v4)
+font -misc-fixed-medium-r-normal--13-120-75-75-C-70-iso10646-1
+directional_focus geometric
+EOT
+
+$pid = launch_with_config($config);
+
+($A, $B, $C, $D) = grid_layout;
+
+cmd 'focus left';
+is($x->input_focus, $B->id, 'B focused (left of D)');
+
+cmd 'focus up';
+is($x->input_focus, $A->id, 'A focused (above B)');
+
+cmd 'focus right';
+is($x->input_focus, $C->id, 'C focused (right of A)');
+
+cmd 'focus down';
+is($x->input_focus, $D->id, 'D focused (below C)');
+
+# Several focus commands in one command list work, too.
+cmd 'focus left, focus up';
+is($x->input_focus, $A->id, 'A focused after focus left, focus up');
+
+######################################################################
+# Containers inside tabbed containers still walk the tree.
+######################################################################
+
+my $tmp = fresh_workspace;
+
+my $first = open_window;
+my $second = open_window;
+cmd 'layout tabbed';
+
+cmd 'focus left';
+is($x->input_focus, $first->id, 'first tab focused');
+
+cmd 'focus left';
+is($x->input_focus, $second->id, 'focus wrapped to the second tab');
+
+exit_gracefully($pid);
+
+done_testing;
@@ -0,0 +1,97 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Verifies that _NET_WM_DESKTOP and _NET_WM_STATE are maintained on managed
+# windows: the desktop number follows the window when it is moved to another
+# workspace and when the list of workspaces changes, and the state reflects
+# fullscreen mode.
+use i3test;
+
+my $CARDINAL = $x->atom(name => 'CARDINAL')->id;
+my $_NET_WM_DESKTOP = $x->atom(name => '_NET_WM_DESKTOP')->id;
+my $_NET_WM_STATE = $x->atom(name => '_NET_WM_STATE')->id;
+my $_NET_WM_STATE_FULLSCREEN = $x->atom(name => '_NET_WM_STATE_FULLSCREEN')->id;
+
+# Returns the _NET_WM_DESKTOP of the given window, or undef if it is not set.
+sub wm_desktop {
+    my ($window) = @_;
+    sync_with_i3;
+
+    my $cookie = $x->get_property(0, $window->id, $_NET_WM_DESKTOP,
+                                  $CARDINAL, 0, 1);
+    my $reply = $x->get_property_reply($cookie->{sequence});
+
+    return undef if $reply->{value_len} != 1;
+    return unpack 'L', $reply->{value};
+}
+
+# Returns the atoms in the _NET_WM_STATE of the given window.
+sub wm_state {
+    my ($window) = @_;
+    sync_with_i3;
+
+    my $cookie = $x->get_property(0, $window->id, $_NET_WM_STATE,
+                                  $x->atom(name => 'ATOM')->id, 0, 32);
+    my $reply = $x->get_property_reply($cookie->{sequence});
+
+    return unpack 'L*', $reply->{value};
+}
+
+cmd 'workspace 1';
+my $first = open_window;
+is(wm_desktop($first), 0, 'window on the first workspace is on desktop 0');
+
+cmd 'workspace 3';
+my $second = open_window;
+is(wm_desktop($second), 1, 'window on the second workspace is on desktop 1');
+
+cmd 'move container to workspace 1';
+is(wm_desktop($second), 0, 'desktop changes when the window is moved');
+
+# Workspace 3 is empty now, so a new workspace 2 is the second desktop.
+cmd 'workspace 2';
+my $third = open_window;
+cmd 'workspace 4';
+my $fourth = open_window;
+is(wm_desktop($fourth), 2, 'window on the third workspace is on desktop 2');
+
+# Closing workspace 2 renumbers the desktops after it.
+cmd '[id="' . $third->id . '"] kill';
+cmd 'workspace 1';
+wait_for_unmap $third;
+is(wm_desktop($fourth), 1, 'desktop changes when workspaces before it are closed');
+
+################################################################################
+# Scratchpad windows are not on any desktop.
+################################################################################
+
+cmd '[id="' . $first->id . '"] move scratchpad';
+is(wm_desktop($first), undef, 'scratchpad window has no desktop');
+
+cmd '[id="' . $first->id . '"] scratchpad show';
+is(wm_desktop($first), 0, 'desktop is set again when the window is shown');
+
+################################################################################
+# _NET_WM_STATE reflects fullscreen mode.
+################################################################################
+
+cmd '[id="' . $second->id . '"] fullscreen enable';
+is_deeply([ wm_state($second) ], [ $_NET_WM_STATE_FULLSCREEN ], 'fullscreen window has _NET_WM_STATE_FULLSCREEN');
+
+cmd '[id="' . $second->id . '"] fullscreen disable';
+is_deeply([ wm_state($second) ], [ ], '_NET_WM_STATE is cleared again');
+
+done_testing;
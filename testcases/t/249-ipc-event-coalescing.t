@@ -0,0 +1,132 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that IPC events are queued and that redundant ones are coalesced:
+# switching through several workspaces in one command results in a single
+# workspace focus event (from the first to the last workspace), unless the
+# client subscribed to every event with the :all flavor.
+use i3test;
+use IO::Select;
+use IO::Socket::UNIX;
+use JSON::XS;
+
+# Raw connections are used (instead of AnyEvent::I3), so that the order of
+# events and replies on the socket can be checked.
+sub connect_and_subscribe {
+    my ($event) = @_;
+
+    my $sock = IO::Socket::UNIX->new(Peer => get_socket_path())
+        or die "Could not connect to i3: $!";
+    send_message($sock, 2, encode_json([ $event ]));
+    my ($type, $payload) = read_message($sock);
+    is($type, 2, "reply to subscribing to $event");
+    ok(decode_json($payload)->{success}, "subscribing to $event succeeded");
+    return $sock;
+}
+
+sub send_message {
+    my ($sock, $type, $payload) = @_;
+    $sock->print('i3-ipc' . pack('LL', length($payload), $type) . $payload);
+    $sock->flush;
+}
+
+sub read_message {
+    my ($sock) = @_;
+    my $header;
+    read($sock, $header, 14) == 14 or die "Could not read the message header";
+    my ($magic, $length, $type) = unpack('a6LL', $header);
+    my $payload = '';
+    read($sock, $payload, $length) == $length or die "Could not read the payload" if $length > 0;
+    return ($type, $payload);
+}
+
+# Event messages have the highest bit set, workspace events are event 0.
+my $workspace_event = (1 << 31) | 0;
+
+sub is_focus_event {
+    my ($type, $payload) = @_;
+    return $type == $workspace_event && decode_json($payload)->{change} eq 'focus';
+}
+
+# Runs the command on the given connection and returns the workspace focus
+# events which were received before the reply.
+sub run_command {
+    my ($sock, $command) = @_;
+
+    send_message($sock, 0, $command);
+    my @events;
+    while (1) {
+        my ($type, $payload) = read_message($sock);
+        if ($type == 0) {
+            ok(decode_json($payload)->[0]->{success}, "'$command' succeeded");
+            return @events;
+        }
+        push @events, decode_json($payload) if is_focus_event($type, $payload);
+    }
+}
+
+# Returns the workspace focus events which are waiting on the given
+# connection. sync_with_i3 makes sure that all events were sent.
+sub pending_events {
+    my ($sock) = @_;
+
+    sync_with_i3;
+    my $select = IO::Select->new($sock);
+    my @events;
+    while ($select->can_read(0)) {
+        my ($type, $payload) = read_message($sock);
+        push @events, decode_json($payload) if is_focus_event($type, $payload);
+    }
+    return @events;
+}
+
+my $sock = connect_and_subscribe('workspace');
+my $sock_all = connect_and_subscribe('workspace:all');
+
+my $first = fresh_workspace;
+my $base = get_unused_workspace;
+my @others = map { "$base-$_" } (1 .. 3);
+
+pending_events($_) for ($sock, $sock_all);
+
+################################################################################
+# Switching through several workspaces in one command results in one event,
+# which is sent before the reply to the command.
+################################################################################
+
+my @events = run_command($sock, join('; ', map { "workspace $_" } @others));
+is(scalar @events, 1, 'one workspace focus event before the reply');
+is($events[0]->{current}->{name}, $others[2], 'current is the last workspace');
+is($events[0]->{old}->{name}, $first, 'old is the first workspace');
+is(scalar pending_events($sock), 0, 'no further events after the reply');
+
+my @all_events = pending_events($sock_all);
+is(scalar @all_events, 3, 'every workspace focus event with the :all flavor');
+is_deeply([ map { $_->{current}->{name} } @all_events ], \@others,
+          'the events are sent in order');
+is($all_events[1]->{old}->{name}, $others[0], 'intermediate old workspace is included');
+
+################################################################################
+# Switching away from an empty workspace closes it while its focus event is
+# still queued.
+################################################################################
+
+@events = run_command($sock, "workspace $first");
+is(scalar @events, 1, 'one workspace focus event for a single switch');
+is($events[0]->{current}->{name}, $first, 'current is the focused workspace');
+is($events[0]->{old}->{name}, $others[2], 'old is the closed workspace');
+
+done_testing;
@@ -0,0 +1,122 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests the shared memory ring buffer transport for IPC events
+# (SUBSCRIBE_RING): events are written to the ring and the socket only carries
+# a wakeup when the client had consumed all previous events.
+use i3test;
+use IO::Select;
+use IO::Socket::UNIX;
+use JSON::XS;
+
+my $I3_IPC_EVENT_RING_WAKEUP = (1 << 31) | 6;
+
+my $sock = IO::Socket::UNIX->new(Peer => get_socket_path())
+    or die "Could not connect to i3: $!";
+
+sub send_message {
+    my ($type, $payload) = @_;
+    $sock->print('i3-ipc' . pack('LL', length($payload), $type) . $payload);
+    $sock->flush;
+}
+
+sub read_message {
+    my $header;
+    read($sock, $header, 14) == 14 or die "Could not read the message header";
+    my ($magic, $length, $type) = unpack('a6LL', $header);
+    my $payload = '';
+    read($sock, $payload, $length) if $length > 0;
+    return ($type, $payload);
+}
+
+sub message_pending {
+    return IO::Select->new($sock)->can_read(0.5);
+}
+
+send_message(9, '[ "window" ]');
+my ($type, $payload) = read_message;
+is($type, 9, 'reply type is SUBSCRIBE_RING');
+
+my $reply = decode_json($payload);
+ok($reply->{success}, 'subscribing with a ring buffer succeeded');
+
+my $path = "/dev/shm$reply->{name}";
+
+SKIP: {
+    skip "$path is not accessible", 8 unless -e $path;
+
+    # Returns the header fields and all events between read_offset and
+    # write_offset.
+    sub read_ring {
+        open(my $fh, '<', $path) or die "Could not open $path: $!";
+        binmode($fh);
+        local $/;
+        my $ring = <$fh>;
+        close($fh);
+
+        my ($magic, $size, $reserved, $write, $read, $dropped) = unpack('a8LLQQQ', $ring);
+        my $data = substr($ring, 40);
+        my @events;
+        while ($read < $write) {
+            my $position = $read % $size;
+            my ($event_type, $length) = unpack('LL', substr($data, $position, 8));
+            my $padded = ($length + 8 + 7) & ~7;
+            push @events, decode_json(substr($data, $position + 8, $length))
+                if $event_type != 0;
+            $read += $padded;
+        }
+        return ($magic, $write, $dropped, @events);
+    }
+
+    # Stores the read_offset, i.e. marks all events as consumed.
+    sub consume_ring {
+        my ($write) = @_;
+        open(my $fh, '+<', $path) or die "Could not open $path: $!";
+        binmode($fh);
+        seek($fh, 24, 0);
+        print $fh pack('Q', $write);
+        close($fh);
+    }
+
+    fresh_workspace;
+    my $window = open_window;
+    sync_with_i3;
+
+    ($type) = read_message;
+    is($type, $I3_IPC_EVENT_RING_WAKEUP, 'wakeup received on the socket');
+
+    my ($magic, $write, $dropped, @events) = read_ring;
+    is($magic, 'i3-ring1', 'ring magic is set');
+    is($dropped, 0, 'no events were dropped');
+    my @new = grep { $_->{change} eq 'new' } @events;
+    is(scalar @new, 1, 'window::new event in the ring');
+    is($new[0]->{container}->{window}, $window->id, 'event refers to the new window');
+
+    # Without consuming the events, there is no further wakeup.
+    open_window;
+    sync_with_i3;
+    ok(!message_pending, 'no wakeup while events are not consumed');
+
+    ($magic, $write) = read_ring;
+    consume_ring($write);
+
+    open_window;
+    sync_with_i3;
+    ($type) = read_message;
+    is($type, $I3_IPC_EVENT_RING_WAKEUP, 'wakeup received after consuming the events');
+}
+
+done_testing;
@@ -0,0 +1,129 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that GET_TREE and GET_WORKSPACES replies are encoded as CBOR when the
+# client sets I3_IPC_MESSAGE_FLAG_CBOR and that they contain the same data as
+# the JSON replies.
+use i3test;
+use IO::Socket::UNIX;
+use JSON::XS;
+
+my $I3_IPC_MESSAGE_FLAG_CBOR = (1 << 30);
+
+my $sock = IO::Socket::UNIX->new(Peer => get_socket_path())
+    or die "Could not connect to i3: $!";
+
+sub send_message {
+    my ($type, $payload) = @_;
+    $sock->print('i3-ipc' . pack('LL', length($payload), $type) . $payload);
+    $sock->flush;
+}
+
+sub read_message {
+    my $header;
+    read($sock, $header, 14) == 14 or die "Could not read the message header";
+    my ($magic, $length, $type) = unpack('a6LL', $header);
+    my $payload = '';
+    read($sock, $payload, $length) if $length > 0;
+    return ($type, $payload);
+}
+
+# Decodes the subset of CBOR which i3 generates (maps and arrays of
+# indefinite length) into the same structure as JSON::XS would.
+sub decode_cbor {
+    my ($data) = @_;
+    my $pos = 0;
+    my %formats = (1 => 'C', 2 => 'n', 4 => 'N', 8 => 'Q>');
+    my $item;
+    $item = sub {
+        my $initial = ord(substr($data, $pos++, 1));
+        my ($major, $info) = ($initial >> 5, $initial & 0x1f);
+        my $argument = $info;
+        if ($info >= 24 && $info <= 27) {
+            my $bytes = 1 << ($info - 24);
+            $argument = unpack($formats{$bytes}, substr($data, $pos, $bytes));
+            $pos += $bytes;
+        }
+
+        return $argument if $major == 0;
+        return -1 - $argument if $major == 1;
+        if ($major == 3) {
+            my $string = substr($data, $pos, $argument);
+            $pos += $argument;
+            utf8::decode($string);
+            return $string;
+        }
+        if ($major == 4 && $info == 31) {
+            my @array;
+            push @array, $item->() until ord(substr($data, $pos, 1)) == 0xff;
+            $pos++;
+            return \@array;
+        }
+        if ($major == 5 && $info == 31) {
+            my %map;
+            until (ord(substr($data, $pos, 1)) == 0xff) {
+                my $key = $item->();
+                $map{$key} = $item->();
+            }
+            $pos++;
+            return \%map;
+        }
+        if ($major == 7) {
+            return $JSON::XS::false if $info == 20;
+            return $JSON::XS::true if $info == 21;
+            return undef if $info == 22;
+            return unpack('d>', pack('Q>', $argument)) if $info == 27;
+        }
+        die "Unexpected CBOR item 0x" . sprintf('%02x', $initial) . " at $pos";
+    };
+
+    my $result = $item->();
+    die "Trailing data after the CBOR item" if $pos != length($data);
+    return $result;
+}
+
+sub get_json {
+    my ($type) = @_;
+    send_message($type, '');
+    my ($reply_type, $payload) = read_message;
+    return decode_json($payload);
+}
+
+sub get_cbor {
+    my ($type) = @_;
+    send_message($type | $I3_IPC_MESSAGE_FLAG_CBOR, '');
+    my ($reply_type, $payload) = read_message;
+    is($reply_type, $type | $I3_IPC_MESSAGE_FLAG_CBOR, "reply to message type $type is CBOR-encoded");
+    return decode_cbor($payload);
+}
+
+fresh_workspace;
+open_window(name => "CBOR \x{2603}");
+open_window;
+cmd 'split v';
+open_window;
+sync_with_i3;
+
+is_deeply(get_cbor(4), get_json(4), 'GET_TREE: CBOR reply matches the JSON reply');
+is_deeply(get_cbor(1), get_json(1), 'GET_WORKSPACES: CBOR reply matches the JSON reply');
+
+# Other message types ignore the flag and reply with JSON.
+send_message(7 | $I3_IPC_MESSAGE_FLAG_CBOR, '');
+my ($type, $payload) = read_message;
+is($type, 7, 'GET_VERSION ignores the CBOR flag');
+ok(defined(decode_json($payload)->{human_readable}), 'GET_VERSION reply is JSON');
+
+done_testing;
@@ -0,0 +1,77 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that large GET_TREE replies (which are written by a worker thread) are
+# complete and that replies to later requests on the same connection are not
+# sent before them.
+use i3test;
+use IO::Socket::UNIX;
+use JSON::XS;
+use List::Util qw(sum);
+
+my $sock = IO::Socket::UNIX->new(Peer => get_socket_path())
+    or die "Could not connect to i3: $!";
+
+sub send_message {
+    my ($type, $payload) = @_;
+    $sock->print('i3-ipc' . pack('LL', length($payload), $type) . $payload);
+    $sock->flush;
+}
+
+sub read_message {
+    my $header;
+    read($sock, $header, 14) == 14 or die "Could not read the message header";
+    my ($magic, $length, $type) = unpack('a6LL', $header);
+    my $payload = '';
+    read($sock, $payload, $length) == $length or die "Could not read the payload" if $length > 0;
+    return ($type, $payload);
+}
+
+sub count_windows {
+    my ($node, $name) = @_;
+    my $count = (defined($node->{name}) && $node->{name} eq $name ? 1 : 0);
+    return $count + sum(0, map { count_windows($_, $name) } (@{$node->{nodes}}, @{$node->{floating_nodes}}));
+}
+
+# Long window titles make the tree large enough to be handled by a worker
+# thread.
+my $name = 'worker ' x 600;
+fresh_workspace;
+open_window(name => $name) for 1 .. 20;
+sync_with_i3;
+
+# Send both requests at once, the reply to the command must not overtake the
+# tree.
+send_message(4, '');
+send_message(0, 'nop');
+
+my ($type, $payload) = read_message;
+is($type, 4, 'first reply is the tree');
+cmp_ok(length($payload), '>', 64 * 1024, 'tree is large');
+my $tree = decode_json($payload);
+is(count_windows($tree, $name), 20, 'tree contains all windows');
+
+($type, $payload) = read_message;
+is($type, 0, 'second reply is the command reply');
+ok(decode_json($payload)->[0]->{success}, 'command succeeded');
+
+# The connection keeps working afterwards.
+send_message(4, '');
+($type, $payload) = read_message;
+is($type, 4, 'tree can be requested again');
+is(count_windows(decode_json($payload), $name), 20, 'tree still contains all windows');
+
+done_testing;
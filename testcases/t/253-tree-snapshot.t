@@ -0,0 +1,110 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that GET_TREE replies are served from tree snapshots which follow all
+# changes of the tree, and that restarting from the crash dialog restores the
+# layout.
+use i3test i3_autostart => 0;
+use IO::Select;
+use IO::Socket::UNIX;
+use JSON::XS;
+
+my $config = <<EOT;
+# i3 config file (v4)
+font -misc-fixed-medium-r-normal--13-120-75-75-C-70-iso10646-1
+EOT
+
+my $pid = launch_with_config($config, enable_signalhandler => 1);
+
+sub send_message {
+    my ($sock, $type, $payload) = @_;
+    $sock->print('i3-ipc' . pack('LL', length($payload), $type) . $payload);
+    $sock->flush;
+}
+
+sub read_message {
+    my ($sock) = @_;
+    my $header;
+    read($sock, $header, 14) == 14 or die "Could not read the message header";
+    my ($magic, $length, $type) = unpack('a6LL', $header);
+    my $payload = '';
+    read($sock, $payload, $length) == $length or die "Could not read the payload" if $length > 0;
+    return ($type, $payload);
+}
+
+my $sock = IO::Socket::UNIX->new(Peer => get_socket_path())
+    or die "Could not connect to i3: $!";
+
+sub get_tree_payload {
+    send_message($sock, 4, '');
+    my ($type, $payload) = read_message($sock);
+    is($type, 4, 'reply is a tree');
+    return $payload;
+}
+
+################################################################################
+# Repeated requests get the same snapshot, changes are reflected right away.
+################################################################################
+
+my $tmp = fresh_workspace;
+open_window;
+open_window;
+
+my $tree = get_tree_payload;
+is(get_tree_payload, $tree, 'unchanged tree is served from the same snapshot');
+
+cmd 'mark snapshot';
+$tree = get_tree_payload;
+like($tree, qr/"mark":"snapshot"/, 'mark is reflected');
+
+cmd 'layout tabbed';
+is(get_ws($tmp)->{nodes}->[0]->{layout}, 'tabbed', 'layout change is reflected');
+
+################################################################################
+# After a crash, restarting in-place restores the layout.
+################################################################################
+
+SKIP: {
+    qx(which xdotool 2> /dev/null);
+
+    skip 'xdotool is required to use the crash dialog. `[apt-get install|pacman -S] xdotool`', 4 if $?;
+
+    sync_with_i3;
+
+    kill('SEGV', $pid);
+
+    # The activation socket outlives the restart, so this request is answered
+    # by the restarted i3. Keep pressing 'r' until the crash dialog took it.
+    my $after = IO::Socket::UNIX->new(Peer => get_socket_path())
+        or die "Could not connect to i3: $!";
+    send_message($after, 7, '');
+    my $select = IO::Select->new($after);
+    for (1 .. 40) {
+        qx(xdotool key r);
+        last if $select->can_read(0.25);
+    }
+    ok($select->can_read(0), 'i3 restarted from the crash dialog');
+    my ($type) = read_message($after);
+    is($type, 7, 'reply to GET_VERSION after restarting');
+
+    my $ws = get_ws($tmp);
+    is($ws->{nodes}->[0]->{layout}, 'tabbed', 'layout restored');
+    is(scalar @{$ws->{nodes}->[0]->{nodes}}, 2, 'windows restored');
+}
+
+exit_gracefully($pid);
+
+done_testing;
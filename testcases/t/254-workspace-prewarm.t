@@ -0,0 +1,87 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that workspace_prewarm renders hidden workspaces without mapping them:
+# a window which is moved to a pre-warmed workspace stays unmapped, but the
+# workspace is rendered again, so the tabs are laid out for all windows. This
+# also works after renaming the workspace.
+use i3test i3_autostart => 0;
+use List::Util qw(sum);
+
+my $config = <<EOT;
+# i3 config file (v4)
+font -misc-fixed-medium-r-normal--13-120-75-75-C-70-iso10646-1
+
+workspace_layout tabbed
+workspace_prewarm 64 mb
+EOT
+
+my $pid = launch_with_config($config);
+
+my $hidden = fresh_workspace;
+my @windows = (open_window, open_window);
+
+fresh_workspace;
+push @windows, open_window;
+cmd "move container to workspace $hidden";
+sync_with_i3;
+
+ok(!$_->mapped, 'window on the pre-warmed workspace is not mapped') for @windows;
+
+my $tabbed = get_ws($hidden)->{nodes}->[0];
+is($tabbed->{layout}, 'tabbed', 'windows are in a tabbed container');
+my @tabs = @{$tabbed->{nodes}};
+is(scalar @tabs, 3, 'moved window is on the pre-warmed workspace');
+
+# Checks that the tabs of the given workspace are laid out for all windows.
+sub tabs_laid_out {
+    my ($ws, $num) = @_;
+    my $tabbed = get_ws($ws)->{nodes}->[0];
+    my @tabs = @{$tabbed->{nodes}};
+    my $width = $tabbed->{rect}->{width};
+    cmp_ok($_->{deco_rect}->{width}, '<=', $width / $num + 2, "tab is laid out for $num windows")
+        for @tabs;
+    cmp_ok(abs(sum(map { $_->{deco_rect}->{width} } @tabs) - $width), '<=', 2, 'tabs cover the container');
+    my %tab_x = map { ($_->{deco_rect}->{x} => 1) } @tabs;
+    is(scalar keys %tab_x, $num, 'tabs are side by side');
+}
+
+tabs_laid_out($hidden, 3);
+
+################################################################################
+# A renamed workspace is still pre-warmed.
+################################################################################
+
+my $renamed = get_unused_workspace;
+cmd "rename workspace $hidden to $renamed";
+$hidden = $renamed;
+
+push @windows, open_window;
+cmd "move container to workspace $hidden";
+sync_with_i3;
+
+ok(!$_->mapped, 'window on the renamed workspace is not mapped') for @windows;
+is(scalar @{get_ws($hidden)->{nodes}->[0]->{nodes}}, 4, 'moved window is on the renamed workspace');
+tabs_laid_out($hidden, 4);
+
+cmd "workspace $hidden";
+sync_with_i3;
+
+ok($_->mapped, 'window is mapped when switching to the workspace') for @windows;
+
+exit_gracefully($pid);
+
+done_testing;
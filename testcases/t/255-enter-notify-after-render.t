@@ -0,0 +1,66 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that moving the pointer into a window still focuses it after a render
+# which sent no further requests to the X server: x_push_changes() ignores the
+# EnterNotify events caused by its own requests, but not those caused by the
+# user afterwards.
+use i3test;
+
+$x->root->warp_pointer(0, 0);
+sync_with_i3;
+
+my $tmp = fresh_workspace;
+my $left = open_window;
+my $right = open_window;
+
+# Moves the pointer into the middle of the given window.
+sub warp_into {
+    my ($window) = @_;
+    my ($con) = grep { $_->{window} == $window->id } @{get_ws_content($tmp)};
+    my $rect = $con->{rect};
+    $x->root->warp_pointer($rect->{x} + int($rect->{width} / 2),
+                           $rect->{y} + int($rect->{height} / 2));
+    sync_with_i3;
+}
+
+cmd 'focus left';
+is($x->input_focus, $left->id, 'left window focused');
+
+################################################################################
+# A render which changes nothing visible (only a mark is set).
+################################################################################
+
+cmd 'mark enter-notify';
+warp_into($right);
+is($x->input_focus, $right->id, 'pointer focused the right window after a render');
+
+cmd 'unmark enter-notify';
+warp_into($left);
+is($x->input_focus, $left->id, 'pointer focused the left window after another render');
+
+################################################################################
+# Switching workspaces back and forth maps both windows again, the pointer
+# still focuses windows afterwards.
+################################################################################
+
+fresh_workspace;
+cmd "workspace $tmp";
+sync_with_i3;
+warp_into($right);
+is($x->input_focus, $right->id, 'pointer focused the right window after switching workspaces');
+
+done_testing;
@@ -0,0 +1,102 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that the CBOR parser of libi3 (used by i3-msg --cbor) rejects
+# malformed replies instead of misinterpreting them: integers which do not fit
+# into a long long, items of indefinite length which cannot have one, and long
+# chains of tags.
+use i3test i3_autostart => 0;
+use File::Temp qw(tempdir);
+use IO::Socket::UNIX;
+use POSIX ();
+
+my $I3_IPC_MESSAGE_FLAG_CBOR = (1 << 30);
+my $GET_VERSION = 7;
+
+my $tmpdir = tempdir(CLEANUP => 1);
+my $socket_path = "$tmpdir/ipc.sock";
+
+# Answers one request of i3-msg with the given CBOR reply and returns the exit
+# status and output of i3-msg.
+sub i3_msg_with_reply {
+    my ($reply) = @_;
+
+    unlink($socket_path);
+    my $server = IO::Socket::UNIX->new(Local => $socket_path, Listen => 1)
+        or die "Could not listen on $socket_path: $!";
+
+    my $pid = fork;
+    die "fork: $!" unless defined($pid);
+    if ($pid == 0) {
+        my $client = $server->accept or POSIX::_exit(1);
+        my $header;
+        read($client, $header, 14) == 14 or POSIX::_exit(1);
+        my ($magic, $length, $type) = unpack('a6LL', $header);
+        my $payload;
+        read($client, $payload, $length) if $length > 0;
+        $client->print('i3-ipc' . pack('LL', length($reply), $GET_VERSION | $I3_IPC_MESSAGE_FLAG_CBOR) . $reply);
+        $client->flush;
+        POSIX::_exit(0);
+    }
+    close($server);
+
+    my $output = qx(../i3-msg/i3-msg -s $socket_path --cbor -t get_version 2>&1);
+    my $status = $? >> 8;
+    waitpid($pid, 0);
+    return ($status, $output);
+}
+
+sub parses {
+    my ($reply, $expected, $name) = @_;
+    my ($status, $output) = i3_msg_with_reply($reply);
+    is($status, 0, "$name: parsed");
+    $output =~ s/\s+//g;
+    is($output, $expected, "$name: converted to JSON");
+}
+
+sub rejected {
+    my ($reply, $name) = @_;
+    my ($status, $output) = i3_msg_with_reply($reply);
+    isnt($status, 0, "$name: rejected");
+    like($output, qr/Could not parse CBOR reply/, "$name: reported as malformed");
+}
+
+################################################################################
+# Integers at the limits of a long long are converted, larger ones rejected.
+################################################################################
+
+parses("\x82\x1b\x7f\xff\xff\xff\xff\xff\xff\xff\x3b\x7f\xff\xff\xff\xff\xff\xff\xff",
+       '[9223372036854775807,-9223372036854775808]', 'limits of long long');
+rejected("\x81\x3b\xff\xff\xff\xff\xff\xff\xff\xff", 'negative integer below LLONG_MIN');
+rejected("\x81\x1b\xff\xff\xff\xff\xff\xff\xff\xff", 'integer above LLONG_MAX');
+
+################################################################################
+# Only strings, arrays and maps may have an indefinite length.
+################################################################################
+
+parses("\x9f\x01\xff", '[1]', 'array of indefinite length');
+rejected("\x81\x1f", 'unsigned integer of indefinite length');
+rejected("\x81\x3f", 'negative integer of indefinite length');
+rejected("\x81\xdf\x01", 'tag of indefinite length');
+
+################################################################################
+# Tags are skipped, but count towards the nesting depth.
+################################################################################
+
+parses("\x81" . ("\xc0" x 3) . "\x01", '[1]', 'a few tags');
+rejected("\x81" . ("\xc0" x 10000) . "\x01", 'long chain of tags');
+
+done_testing;
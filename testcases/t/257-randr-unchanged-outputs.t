@@ -0,0 +1,89 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that a RandR screen change notification which does not change any
+# output is ignored (no output event), while one after the primary output was
+# changed is handled.
+use i3test i3_autostart => 0;
+
+my $config = <<EOT;
+# i3 config file (v4)
+font -misc-fixed-medium-r-normal--13-120-75-75-C-70-iso10646-1
+EOT
+
+my $pid = launch_with_config($config);
+
+SKIP: {
+    qx(which xrandr xdpyinfo 2> /dev/null);
+    skip 'xrandr and xdpyinfo are required. `[apt-get install|pacman -S] x11-xserver-utils x11-utils`', 3 if $?;
+
+    my ($randr_base) = (qx(xdpyinfo -queryExtensions) =~ /RANDR\s+\(opcode: \d+, base event: (\d+)/);
+    skip 'the X server does not support RandR', 3 unless defined($randr_base);
+
+    my $i3 = i3(get_socket_path());
+    $i3->connect->recv;
+
+    my @outputs = grep { $_->{active} } @{$i3->get_outputs->recv};
+    skip 'i3 did not find any RandR outputs', 3 unless @outputs;
+
+    my $cv;
+    $i3->subscribe({
+            output => sub { $cv->send(1) },
+        })->recv;
+
+    # Sends a RandR ScreenChangeNotify to i3, like the X server does whenever
+    # the screen configuration might have changed.
+    sub screen_change_notify {
+        my $root = $x->get_root_window();
+        my $msg = pack "CCSLLLLSSSSSS",
+            $randr_base, # response_type (XCB_RANDR_SCREEN_CHANGE_NOTIFY)
+            0, # rotation
+            0, # sequence
+            0, # timestamp
+            0, # config_timestamp
+            $root, # root
+            $root, # request_window
+            0, # sizeID
+            0, # subpixel_order
+            0, # width
+            0, # height
+            0, # mwidth
+            0; # mheight
+
+        $x->send_event(0, $root, X11::XCB::EVENT_MASK_SUBSTRUCTURE_REDIRECT, $msg);
+        $x->flush;
+    }
+
+    sub output_event_after_notify {
+        $cv = AE::cv;
+        my $t = AE::timer(0.5, 0, sub { $cv->send(0) });
+        screen_change_notify;
+        return $cv->recv;
+    }
+
+    ok(!output_event_after_notify, 'no output event when nothing changed');
+
+    my ($primary) = grep { $_->{primary} } @outputs;
+    qx(xrandr --output $outputs[0]->{name} --primary) unless defined($primary);
+    qx(xrandr --noprimary) if defined($primary);
+    ok(output_event_after_notify, 'output event after the primary output changed');
+
+    ok(!output_event_after_notify, 'no output event when nothing changed again');
+}
+
+exit_gracefully($pid);
+
+done_testing;
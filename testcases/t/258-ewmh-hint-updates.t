@@ -0,0 +1,114 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that i3 only rewrites the EWMH desktop properties on the root window
+# when their values changed, and that changes are written before i3 replies to
+# the I3_SYNC client message which followed the change.
+use i3test i3_autostart => 0;
+use X11::XCB qw(:all);
+
+my $config = <<EOT;
+# i3 config file (v4)
+font -misc-fixed-medium-r-normal--13-120-75-75-C-70-iso10646-1
+EOT
+
+my $pid = launch_with_config($config);
+
+my $root = $x->get_root_window;
+$x->change_window_attributes($root, CW_EVENT_MASK, [ EVENT_MASK_PROPERTY_CHANGE ]);
+
+my %atoms = map { ($x->atom(name => $_)->id => $_) }
+    qw(_NET_CURRENT_DESKTOP _NET_NUMBER_OF_DESKTOPS _NET_DESKTOP_NAMES _NET_DESKTOP_VIEWPORT);
+
+# Returns how often each of the desktop properties was written until i3
+# replied to an I3_SYNC client message.
+sub property_writes {
+    my %writes;
+    my $rnd = sync_with_i3(dont_wait_for_event => 1);
+    wait_for_event 4, sub {
+        my ($event) = @_;
+        if ($event->{response_type} == PROPERTY_NOTIFY &&
+            $event->{window} == $root &&
+            exists($atoms{$event->{atom}})) {
+            $writes{$atoms{$event->{atom}}}++;
+        }
+        return 0 unless $event->{response_type} == 161;
+        my ($win, $reply_rnd) = unpack "LL", $event->{data};
+        return ($reply_rnd == $rnd);
+    };
+    return \%writes;
+}
+
+sub send_current_desktop_request {
+    my ($idx) = @_;
+
+    my $msg = pack "CCSLLLLLL",
+        CLIENT_MESSAGE, # response_type
+        32, # format
+        0, # sequence
+        0,
+        $x->atom(name => '_NET_CURRENT_DESKTOP')->id,
+        $idx, # data32[0] (the desktop index)
+        0, # data32[1] (can be a timestamp)
+        0, # data32[2]
+        0, # data32[3]
+        0; # data32[4]
+
+    $x->send_event(0, $root, EVENT_MASK_SUBSTRUCTURE_REDIRECT, $msg);
+}
+
+cmd 'workspace 1';
+open_window;
+cmd 'workspace 2';
+open_window;
+sync_with_i3;
+property_writes;
+
+################################################################################
+# Commands which do not touch workspaces do not rewrite the properties.
+################################################################################
+
+cmd 'mark ewmh';
+cmd 'layout stacking';
+is_deeply(property_writes, {}, 'no desktop property written without workspace changes');
+
+################################################################################
+# Switching between existing workspaces only rewrites _NET_CURRENT_DESKTOP,
+# and the new value is written before the reply to the I3_SYNC which
+# immediately followed the request.
+################################################################################
+
+send_current_desktop_request(0);
+is_deeply(property_writes, { _NET_CURRENT_DESKTOP => 1 },
+          'only _NET_CURRENT_DESKTOP written when switching to workspace 1');
+is(focused_ws, '1', 'switched to workspace 1');
+
+send_current_desktop_request(0);
+is_deeply(property_writes, {}, 'nothing written when staying on workspace 1');
+
+################################################################################
+# Creating a workspace changes the number of desktops and their names.
+################################################################################
+
+cmd 'workspace 3';
+is_deeply(property_writes,
+          { _NET_CURRENT_DESKTOP => 1, _NET_NUMBER_OF_DESKTOPS => 1,
+            _NET_DESKTOP_NAMES => 1, _NET_DESKTOP_VIEWPORT => 1 },
+          'all desktop properties written once when creating a workspace');
+
+exit_gracefully($pid);
+
+done_testing;
@@ -0,0 +1,98 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Verifies that the output containing the pointer and the neighbors of an
+# output are found correctly on a video wall of 4x3 outputs (both are looked
+# up in the output index instead of comparing all outputs).
+use i3test i3_autostart => 0;
+use List::Util qw(first);
+
+my ($width, $height) = (320, 240);
+my @outputs;
+for my $row (0 .. 2) {
+    for my $col (0 .. 3) {
+        push @outputs, "${width}x${height}+" . ($col * $width) . '+' . ($row * $height);
+    }
+}
+my $fake_outputs = join(',', @outputs);
+
+my $config = <<EOT;
+# i3 config file (v4)
+font -misc-fixed-medium-r-normal--13-120-75-75-C-70-iso10646-1
+
+fake-outputs $fake_outputs
+EOT
+my $pid = launch_with_config($config);
+
+my $i3 = i3(get_socket_path());
+
+sub focused_output {
+    my $tree = $i3->get_tree->recv;
+    my $focused = $tree->{focus}->[0];
+    my $output = first { $_->{id} == $focused } @{$tree->{nodes}};
+    return $output->{name};
+}
+
+sub focus_pointer {
+    my ($row, $col) = @_;
+    sync_with_i3;
+    $x->root->warp_pointer($col * $width + $width / 2, $row * $height + $height / 2);
+    sync_with_i3;
+}
+
+################################################################################
+# The output containing the pointer gets focused.
+################################################################################
+
+for my $row (0 .. 2) {
+    for my $col (0 .. 3) {
+        focus_pointer($row, $col);
+        my $expected = 'fake-' . ($row * 4 + $col);
+        is(focused_output, $expected, "pointer on $expected focuses it");
+    }
+}
+
+################################################################################
+# 'focus output <direction>' uses the neighbors of the output.
+################################################################################
+
+focus_pointer(1, 1);
+is(focused_output, 'fake-5', 'focus on fake-5');
+
+cmd 'focus output right';
+is(focused_output, 'fake-6', 'right of fake-5 is fake-6');
+
+cmd 'focus output down';
+is(focused_output, 'fake-10', 'below fake-6 is fake-10');
+
+cmd 'focus output left';
+is(focused_output, 'fake-9', 'left of fake-10 is fake-9');
+
+cmd 'focus output up';
+is(focused_output, 'fake-5', 'above fake-9 is fake-5');
+
+# Focus wraps around to the farthest output in the opposite direction.
+focus_pointer(0, 3);
+cmd 'focus output right';
+is(focused_output, 'fake-0', 'focus wraps from fake-3 to fake-0');
+
+focus_pointer(2, 1);
+cmd 'focus output down';
+is(focused_output, 'fake-1', 'focus wraps from fake-9 to fake-1');
+
+exit_gracefully($pid);
+
+done_testing;
@@ -0,0 +1,54 @@
+#!perl
+# vim:ts=4:sw=4:expandtab
+#
+# Please read the following documents before working on tests:
+# • http://build.i3wm.org/docs/testsuite.html
+#   (or docs/testsuite)
+#
+# • http://build.i3wm.org/docs/lib-i3test.html
+#   (alternatively: perldoc ./testcases/lib/i3test.pm)
+#
+# • http://build.i3wm.org/docs/ipc.html
+#   (or docs/ipc)
+#
+# • http://onyxneon.com/books/modern_perl/modern_perl_a4.pdf
+#   (unless you are already familiar with Perl)
+#
+# Tests that fake-outputs accepts a grid of outputs (colsxrows@wxh), also
+# mixed with single outputs.
+#
+use i3test i3_autostart => 0;
+use List::Util qw(first);
+
+my $config = <<EOT;
+# i3 config file (v4)
+font -misc-fixed-medium-r-normal--13-120-75-75-C-70-iso10646-1
+
+fake-outputs 3x2@640x480,800x600+1920+0
+EOT
+my $pid = launch_with_config($config);
+
+my $i3 = i3(get_socket_path());
+
+my $tree = $i3->get_tree->recv;
+
+my @outputs = map { $_->{name} } @{$tree->{nodes}};
+is_deeply(\@outputs, [ '__i3', map { "fake-$_" } (0 .. 6) ],
+          'grid and single output created');
+
+sub rect_of {
+    my ($name) = @_;
+    my $output = first { $_->{name} eq $name } @{$i3->get_outputs->recv};
+    my $rect = $output->{rect};
+    return [ $rect->{x}, $rect->{y}, $rect->{width}, $rect->{height} ];
+}
+
+is_deeply(rect_of('fake-0'), [ 0, 0, 640, 480 ], 'top left output');
+is_deeply(rect_of('fake-2'), [ 1280, 0, 640, 480 ], 'top right output');
+is_deeply(rect_of('fake-3'), [ 0, 480, 640, 480 ], 'outputs are named row by row');
+is_deeply(rect_of('fake-5'), [ 1280, 480, 640, 480 ], 'bottom right output');
+is_deeply(rect_of('fake-6'), [ 1920, 0, 800, 600 ], 'single output after the grid');
+
+exit_gracefully($pid);
+
+done_testing;